@@ -0,0 +1,192 @@
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Micro benchmarks of the hot paths of the driver
+//
+// Replaces the main() of the Arduino core: sets the driver up like on the
+// board, then measures cycles per call with timer 1 running at the cpu
+// clock, prints one line per benchmark and stops. Runs on the board or under
+// simavr, see tools/bench.py.
+//
+// Output lines: "bench <name> <calls> <mean> <max>" in cycles, overhead of
+// the measurement already subtracted.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+#include <FastLED.h>
+
+#include "Jack.h"
+
+#include "Button.h"
+#include "Receptor.h"
+#include "Indicator.h"
+#include "Listener.h"
+#include "Scheduler.h"
+#include "Timer.h"
+#include "Animations.h"
+
+extern Button button;
+extern Receptor receptor;
+extern Indicator indicator;
+extern Scheduler scheduler;
+
+extern void setup(void);
+extern void loop(void);
+
+namespace {
+
+// extends timer 1 to 32 bits
+volatile uint16_t overflows;
+
+uint32_t overhead = 0;
+
+void start() {
+    TCCR1B = 0;
+    TCCR1A = 0;
+    TCNT1 = 0;
+    overflows = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+    TCCR1B = _BV(CS10);
+}
+
+uint32_t stop() {
+    TCCR1B = 0;
+    uint16_t count = TCNT1;
+    uint32_t high = overflows;
+    // an overflow right before the timer stopped is still pending
+    if (TIFR1 & _BV(TOV1)) {
+        TIFR1 = _BV(TOV1);
+        high++;
+    }
+    uint32_t cycles = (high << 16) | count;
+    return cycles > overhead ? cycles - overhead : 0;
+}
+
+typedef void (*function_t)(void);
+
+void nothing() {
+}
+
+void measure(const __FlashStringHelper *name, uint16_t calls, function_t prepare, function_t run) {
+    uint32_t total = 0;
+    uint32_t maximum = 0;
+    for (uint16_t call = 0; call < calls; call++) {
+        if (prepare) {
+            prepare();
+        }
+        start();
+        run();
+        uint32_t cycles = stop();
+        total += cycles;
+        if (cycles > maximum) {
+            maximum = cycles;
+        }
+    }
+    Serial.print(F("\nbench "));
+    Serial.print(name);
+    Serial.print(' ');
+    Serial.print(calls);
+    Serial.print(' ');
+    Serial.print(total / calls);
+    Serial.print(' ');
+    Serial.print(maximum);
+    Serial.print('\n');
+    Serial.flush();
+}
+
+// timer driven work needs time to pass
+void millisecond() {
+    delay(1);
+}
+
+void frame_due() {
+    delay(41);
+    Timer::tick();
+}
+
+// renders a frame ahead, then the next frame is due
+void frame_ahead() {
+    indicator.loop();
+    frame_due();
+}
+
+// presents the next frame, which leaves a slot to render ahead into
+void frame_presented() {
+    frame_due();
+    indicator.loop();
+}
+
+// samples arrive for the indicator loop, 19 of them
+void samples_due() {
+    delay(4);
+}
+
+void task_due() {
+    delayMicroseconds(500);
+    Timer::tick();
+}
+
+}
+
+ISR(TIMER1_OVF_vect) {
+    overflows++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void) {
+    init();
+
+    setup();
+    // the benchmarks don't feed the watchdog
+    wdt_disable();
+
+    // calibrates with the cost of an empty call
+    start();
+    nothing();
+    overhead = stop();
+
+    measure(F("button.read"), 1000, nullptr, [] { button.read(); });
+    measure(F("receptor.loop"), 1000, nullptr, [] { receptor.loop(); });
+    measure(F("timer.tick"), 200, millisecond, [] { Timer::tick(); });
+    measure(F("scheduler.loop"), 1000, task_due, [] { scheduler.loop(); });
+    // the task of every millisecond is due, so the loop runs it instead of
+    // sleeping
+    measure(F("jack.loop"), 1000, millisecond, [] { loop(); });
+    measure(F("fastled.show"), 20, nullptr, [] { FastLED.show(); });
+
+    indicator.lightUp();
+    measure(F("indicator.fire"), 20, frame_due, [] { indicator.loop(); });
+    // only the swap and the show remain at the deadline
+    measure(F("indicator.ahead"), 20, frame_ahead, [] { indicator.loop(); });
+    #if INDICATOR_AHEAD > 0
+    // a frame rendered ahead, the effect on a copy of the previous frame
+    measure(F("indicator.burn"), 20, frame_presented, [] { indicator.loop(); });
+    #endif
+    indicator.danceIn();
+    measure(F("indicator.disco"), 20, frame_due, [] { indicator.loop(); });
+    #if INDICATOR_AHEAD > 0
+    measure(F("indicator.pulse"), 20, frame_presented, [] { indicator.loop(); });
+    #endif
+    indicator.play(&animations[lightning_animation]);
+    measure(F("indicator.play"), 30, frame_due, [] { indicator.loop(); });
+    indicator.turnOff();
+    // with the sampling interrupts that land within
+    Listener::begin(LISTENER_PIN);
+    measure(F("listener.update"), 50, samples_due, [] { Listener::update(); });
+    Listener::end();
+
+    Serial.print(F("\nbench done\n"));
+    Serial.flush();
+
+    // sleeping with interrupts off ends simavr
+    cli();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu();
+    for (;;);
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "sim.h"
+
+#include "Bus.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Several Jacks on one simulated RS-485 bus
+//
+// Runs the bus of every node against a shared wire on the virtual clock of
+// the simulation, each node with a clock of its own. Bytes on the wire at the
+// same time collide and reach all nodes garbled. The clock of the first node
+// is days ahead of the others (e.g. the others were reset), the clock of the
+// last node runs fast. Triggers single nodes and two nodes at once, then
+// prints when the cascade was due on every node against the schedule, the
+// estimated clock offsets and the statistics of the buses. Exits with 1 if a
+// node missed a cascade, or a cascade or an offset was off by more than the
+// tolerance.
+//
+// Options:
+//  --nodes <n>       nodes on the bus, addresses 1 to n
+//  --baud <baud>     speed of the bus
+//  --cascade <ms>    delay between neighbouring addresses
+//  --skew <s>        how far the clock of the first node is ahead, 8 days
+//  --drift <ppm>     how much faster the clock of the last node runs, 200
+//  --tolerance <ms>  how far cascades and offsets may be off, 5
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+#define ENABLE_PIN 2
+#define STEP_US 100
+
+unsigned long baud = 38400;
+uint16_t cascade = 400;
+int64_t ahead = 8 * 24 * 3600;
+int32_t drift = 200;
+double tolerance = 5;
+unsigned failures = 0;
+
+struct transfer_t {
+    uint64_t start;
+    uint64_t end;
+    uint8_t data;
+    size_t port;
+    bool delivered;
+};
+
+class Port;
+
+std::vector<Port *> ports;
+std::vector<transfer_t> wire;
+
+void settle(void);
+
+// serial of a node, writes go onto the wire, reads come from it
+class Port : public Stream {
+public:
+    Port(size_t number) : number(number), busy(0) {}
+
+    int available(void) { settle(); return int(input.size()); }
+    int read(void) {
+        settle();
+        if (input.empty()) return -1;
+        uint8_t data = input.front();
+        input.pop_front();
+        return data;
+    }
+    int peek(void) { settle(); return input.empty() ? -1 : input.front(); }
+
+    size_t write(uint8_t data) {
+        uint64_t start = std::max(sim::now(), busy);
+        busy = start + 10000000ULL / baud;
+        transfer_t transfer = { start, busy, data, number, false };
+        wire.push_back(transfer);
+        return 1;
+    }
+    using Print::write;
+
+    size_t number;
+    uint64_t busy;
+    std::deque<uint8_t> input;
+};
+
+// delivers the bytes which are through, garbled if they overlapped
+void settle() {
+    uint64_t now = sim::now();
+    std::vector<size_t> through;
+    for (size_t i = 0; i < wire.size(); i++) {
+        if (!wire[i].delivered && wire[i].end <= now) through.push_back(i);
+    }
+    std::sort(through.begin(), through.end(), [](size_t a, size_t b) { return wire[a].end < wire[b].end; });
+    for (size_t i : through) {
+        transfer_t& transfer = wire[i];
+        uint8_t data = transfer.data;
+        for (const transfer_t& other : wire) {
+            if (other.port != transfer.port && other.start < transfer.end && transfer.start < other.end) {
+                data ^= other.data ^ 0x5A;
+            }
+        }
+        for (Port *port : ports) port->input.push_back(data);
+        transfer.delivered = true;
+    }
+    // keep what may still overlap with bytes on the way
+    uint64_t window = 2 * 10000000ULL / baud;
+    wire.erase(std::remove_if(wire.begin(), wire.end(), [&](const transfer_t& transfer) {
+        return transfer.delivered && transfer.end + window < now;
+    }), wire.end());
+}
+
+struct node_t {
+    uint8_t address;
+    // offset of the clock at the start and its rate against the simulation
+    int64_t skew;
+    int32_t drift;
+    Port *port;
+    Bus *bus;
+    bool due;
+    uint64_t due_us;
+};
+
+std::vector<node_t> nodes;
+
+// offset of the clock of the node by now
+int64_t skew(const node_t& node) {
+    return node.skew + int64_t(sim::now()) * node.drift / 1000000;
+}
+
+// runs all nodes for a while, notes when cascades are due
+void run(uint64_t us) {
+    uint64_t until = sim::now() + us;
+    while (sim::now() < until) {
+        for (node_t& node : nodes) {
+            sim::setSkew(skew(node));
+            node.bus->loop();
+            if (node.bus->isDue() && !node.due) {
+                node.due = true;
+                node.due_us = sim::now();
+            }
+        }
+        sim::setSkew(0);
+        sim::advance(STEP_US);
+    }
+}
+
+// triggers the nodes at once and checks when the others follow
+void scenario(const std::vector<uint8_t>& origins) {
+    for (node_t& node : nodes) node.due = false;
+
+    uint64_t at = sim::now();
+    printf("trigger");
+    for (uint8_t origin : origins) {
+        node_t& node = nodes[origin - 1];
+        sim::setSkew(skew(node));
+        node.bus->trigger();
+        printf(" %u", origin);
+    }
+    sim::setSkew(0);
+    printf(" at %.3f s\n", double(at) / 1e6);
+
+    run(uint64_t(cascade) * nodes.size() * 1000 + 2000000);
+
+    for (node_t& node : nodes) {
+        if (std::find(origins.begin(), origins.end(), node.address) != origins.end()) continue;
+        uint32_t expected = UINT32_MAX;
+        for (uint8_t origin : origins) {
+            uint32_t distance = origin > node.address ? origin - node.address : node.address - origin;
+            expected = std::min(expected, distance * cascade);
+        }
+        if (!node.due) {
+            printf("  node %u missed the cascade, expected +%u ms\n", node.address, expected);
+            failures++;
+            continue;
+        }
+        double delay = double(node.due_us - at) / 1000.0;
+        bool off = delay - expected > tolerance || expected - delay > tolerance;
+        printf("  node %u due +%.1f ms, expected +%u ms, off by %+.1f ms%s\n",
+            node.address, delay, expected, delay - expected, off ? " (too far)" : "");
+        if (off) failures++;
+    }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    unsigned count = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--nodes") && i + 1 < argc) count = unsigned(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--baud") && i + 1 < argc) baud = strtoul(argv[++i], 0, 10);
+        else if (!strcmp(argv[i], "--cascade") && i + 1 < argc) cascade = uint16_t(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--skew") && i + 1 < argc) ahead = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--drift") && i + 1 < argc) drift = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+    }
+    if (count < 2 || count >= Bus::Nodes) {
+        fprintf(stderr, "2 to %d nodes\n", Bus::Nodes - 1);
+        return 1;
+    }
+
+    sim::reset();
+    sim::setTrace(0);
+
+    for (unsigned number = 0; number < count; number++) {
+        node_t node;
+        node.address = uint8_t(number + 1);
+        // clocks apart by seconds and some odd microseconds
+        node.skew = int64_t((number * 7919) % 5000) * 1000 + int64_t(number) * 373;
+        if (number == 0) node.skew += ahead * 1000000;
+        node.drift = number + 1 == count ? drift : 0;
+        node.port = new Port(number);
+        node.bus = new Bus(*node.port, ENABLE_PIN, node.address, baud, cascade);
+        node.due = false;
+        ports.push_back(node.port);
+        nodes.push_back(node);
+    }
+    for (node_t& node : nodes) {
+        sim::setSkew(skew(node));
+        node.bus->begin();
+    }
+    sim::setSkew(0);
+
+    // beacons first
+    run(3000000);
+
+    scenario({ 1 });
+    scenario({ uint8_t((count + 1) / 2) });
+    scenario({ 2, uint8_t(count - 1) });
+    scenario({ uint8_t(count) });
+
+    printf("clock offsets, estimated against actual\n");
+    for (node_t& node : nodes) {
+        printf("  node %u:", node.address);
+        for (node_t& other : nodes) {
+            int32_t offset;
+            if (&other == &node) continue;
+            if (node.bus->offset(other.address, offset)) {
+                double error = double(offset) - double(skew(other) - skew(node)) / 1000.0;
+                // the offsets are modulo 2^32 ms like the clocks
+                error -= 4294967296.0 * floor(error / 4294967296.0 + 0.5);
+                printf(" %u %+.1f", other.address, error);
+                if (error > tolerance || -error > tolerance) failures++;
+            }
+            else {
+                printf(" %u ?", other.address);
+                failures++;
+            }
+        }
+        printf(" ms\n");
+    }
+
+    printf("node     sent collisions received corrupted lost latency\n");
+    for (node_t& node : nodes) {
+        Bus::statistics_t statistics = node.bus->statistics();
+        printf("%4u %8u %10u %8u %9u %4u %5u ms\n", node.address, statistics.sent, statistics.collisions,
+            statistics.received, statistics.corrupted, statistics.lost, statistics.latency);
+    }
+
+    if (failures > 0) {
+        printf("%u failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef __SIM_DFMINIMP3_H__
+#define __SIM_DFMINIMP3_H__
+
+#include <Arduino.h>
+
+namespace sim {
+void mp3Volume(uint8_t volume);
+void mp3Play(uint16_t track);
+void mp3Stop(void);
+}
+
+template<class T_SERIAL_METHOD, class T_NOTIFICATION_METHOD> class DFMiniMp3 {
+public:
+    DFMiniMp3(T_SERIAL_METHOD& serial) : serial(serial) {}
+    void begin(void) { serial.begin(9600); }
+    void loop(void) {}
+    void setVolume(uint8_t volume) { sim::mp3Volume(volume); }
+    void playMp3FolderTrack(uint16_t track) { sim::mp3Play(track); }
+    void stop(void) { sim::mp3Stop(); }
+    void sleep(void) {}
+    void reset(void) {}
+private:
+    T_SERIAL_METHOD& serial;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef __SIM_EEPROM_H__
+#define __SIM_EEPROM_H__
+
+#include <Arduino.h>
+
+namespace sim {
+uint8_t *eeprom(void);
+void eepromWritten(uint16_t address);
+}
+
+#define E2END 0x3FF
+
+class EEPROMClass {
+public:
+    uint8_t read(int address) { return sim::eeprom()[address & E2END]; }
+    void write(int address, uint8_t value) {
+        sim::eeprom()[address & E2END] = value;
+        sim::eepromWritten(uint16_t(address & E2END));
+    }
+    void update(int address, uint8_t value) { if (read(address) != value) write(address, value); }
+    uint16_t length(void) { return E2END + 1; }
+
+    template<typename T> T& get(int address, T& t) {
+        uint8_t *bytes = reinterpret_cast<uint8_t *>(&t);
+        for (size_t i = 0; i < sizeof(T); i++) bytes[i] = read(address + int(i));
+        return t;
+    }
+    template<typename T> const T& put(int address, const T& t) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&t);
+        for (size_t i = 0; i < sizeof(T); i++) update(address + int(i), bytes[i]);
+        return t;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef __SIM_FASTLED_H__
+#define __SIM_FASTLED_H__
+
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+
+struct CRGB {
+    union {
+        struct { uint8_t r; uint8_t g; uint8_t b; };
+        uint8_t raw[3];
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+
+    uint8_t& operator[](uint8_t x) { return raw[x]; }
+    const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+    bool operator==(const CRGB& rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+    bool operator!=(const CRGB& rhs) const { return !(*this == rhs); }
+
+    CRGB& nscale8_video(uint8_t scale);
+
+    enum { Black = 0x000000, White = 0xFFFFFF };
+};
+
+struct CHSV {
+    uint8_t h, s, v;
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+class CRGBPalette16 {
+public:
+    CRGB entries[16];
+
+    CRGBPalette16(const CRGB& c00, const CRGB& c01, const CRGB& c02, const CRGB& c03,
+                  const CRGB& c04, const CRGB& c05, const CRGB& c06, const CRGB& c07,
+                  const CRGB& c08, const CRGB& c09, const CRGB& c10, const CRGB& c11,
+                  const CRGB& c12, const CRGB& c13, const CRGB& c14, const CRGB& c15) {
+        const CRGB *c[16] = { &c00, &c01, &c02, &c03, &c04, &c05, &c06, &c07,
+                              &c08, &c09, &c10, &c11, &c12, &c13, &c14, &c15 };
+        for (uint8_t i = 0; i < 16; i++) entries[i] = *c[i];
+    }
+};
+
+enum TBlendType { NOBLEND = 0, LINEARBLEND = 1 };
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+template<uint8_t DATA_PIN, EOrder RGB_ORDER> class APA106 {};
+
+uint8_t scale8(uint8_t i, fract8 scale);
+uint8_t scale8_video(uint8_t i, fract8 scale);
+uint8_t qadd8(uint8_t i, uint8_t j);
+uint8_t qsub8(uint8_t i, uint8_t j);
+uint8_t random8(void);
+uint8_t random8(uint8_t lim);
+uint8_t random8(uint8_t min, uint8_t lim);
+uint8_t sin8(uint8_t theta);
+uint8_t cubicwave8(uint8_t in);
+uint8_t ease8InOutCubic(fract8 i);
+uint8_t beat8(uint16_t beats_per_minute, uint32_t timebase = 0);
+uint8_t beatsin8(uint16_t beats_per_minute, uint8_t lowest = 0, uint8_t highest = 255,
+                 uint32_t timebase = 0, uint8_t phase_offset = 0);
+
+CRGB HeatColor(uint8_t temperature);
+CRGB ColorFromPalette(const CRGBPalette16& pal, uint8_t index, uint8_t brightness = 255,
+                      TBlendType blendType = LINEARBLEND);
+
+class CLEDController {
+public:
+    CLEDController() : leds(0), count(0) {}
+    virtual ~CLEDController() {}
+
+    CLEDController& setLeds(CRGB *data, int nLeds) { leds = data; count = nLeds; return *this; }
+    CRGB *leds;
+    int count;
+
+    virtual void init(void) {}
+    virtual void show(const CRGB *data, int nLeds, uint8_t brightness);
+};
+
+// pixels in the order of the wire, scaled by the brightness
+template<EOrder RGB_ORDER> class PixelController {
+public:
+    PixelController(const CRGB *data, int nLeds, uint8_t brightness)
+        : data(data), left(nLeds), brightness(brightness) {}
+
+    bool has(int n) { return left >= n; }
+    int size(void) { return left; }
+    uint8_t loadAndScale0(void) { return scale8(data->raw[(RGB_ORDER >> 6) & 3], brightness); }
+    uint8_t loadAndScale1(void) { return scale8(data->raw[(RGB_ORDER >> 3) & 3], brightness); }
+    uint8_t loadAndScale2(void) { return scale8(data->raw[RGB_ORDER & 3], brightness); }
+    void advanceData(void) { data++; left--; }
+    void stepDithering(void) {}
+
+private:
+    const CRGB *data;
+    int left;
+    uint8_t brightness;
+};
+
+// records the frame like any controller, then hands the pixels to the driver
+template<EOrder RGB_ORDER> class CPixelLEDController : public CLEDController {
+public:
+    virtual void showPixels(PixelController<RGB_ORDER>& pixels) = 0;
+
+    virtual void show(const CRGB *data, int nLeds, uint8_t brightness) {
+        CLEDController::show(data, nLeds, brightness);
+        PixelController<RGB_ORDER> pixels(data, nLeds, brightness);
+        showPixels(pixels);
+    }
+};
+
+class CFastLED {
+public:
+    CFastLED() : controller(0), brightness(255) {}
+
+    template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController& addLeds(CRGB *data, int nLeds) {
+        static CLEDController c;
+        return addLeds(&c, data, nLeds);
+    }
+    CLEDController& addLeds(CLEDController *pLed, CRGB *data, int nLeds) {
+        controller = pLed;
+        controller->setLeds(data, nLeds);
+        controller->init();
+        return *controller;
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness(void) { return brightness; }
+
+    void show(void) { show(brightness); }
+    void show(uint8_t scale);
+    void clear(bool writeData = false);
+
+private:
+    CLEDController *controller;
+    uint8_t brightness;
+};
+
+extern CFastLED FastLED;
+
+#endif
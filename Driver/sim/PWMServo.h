@@ -0,0 +1,18 @@
+#ifndef __SIM_PWMSERVO_H__
+#define __SIM_PWMSERVO_H__
+
+#include <Arduino.h>
+
+class PWMServo {
+public:
+    PWMServo() : pin(0xFF), angle(0) {}
+    uint8_t attach(int pinArg);
+    void write(int angleArg);
+    uint8_t read(void) { return angle; }
+    uint8_t attached(void) { return pin != 0xFF; }
+private:
+    uint8_t pin;
+    uint8_t angle;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef __SIM_SOFTWARESERIAL_H__
+#define __SIM_SOFTWARESERIAL_H__
+
+#include <Arduino.h>
+
+class SoftwareSerial : public Stream {
+public:
+    SoftwareSerial(uint8_t receivePin, uint8_t transmitPin) { (void)receivePin; (void)transmitPin; }
+    void begin(long speed) { (void)speed; }
+    bool listen(void) { return true; }
+    int available(void) { return 0; }
+    int read(void) { return -1; }
+    int peek(void) { return -1; }
+    size_t write(uint8_t c) { (void)c; return 1; }
+    using Print::write;
+};
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __SIM_AVR_EEPROM_H__
+#define __SIM_AVR_EEPROM_H__
+
+// writes complete at once in the simulation
+#define eeprom_is_ready() 1
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __SIM_AVR_IO_H__
+#define __SIM_AVR_IO_H__
+
+#include <stdint.h>
+
+// Registers of the ATmega328P touched by the driver, as plain memory.
+
+#define _BV(bit) (1 << (bit))
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+extern volatile uint8_t PCICR;
+extern volatile uint8_t PCIFR;
+extern volatile uint8_t PCMSK0;
+extern volatile uint8_t PCMSK1;
+extern volatile uint8_t PCMSK2;
+
+extern volatile uint8_t MCUSR;
+extern volatile uint8_t WDTCSR;
+#define WDIE 6
+
+extern volatile uint8_t DDRB;
+extern volatile uint8_t PORTB;
+#define DDB2 2
+#define DDB3 3
+#define DDB5 5
+#define PORTB3 3
+
+// SPIF is always set, transfers complete at once
+extern volatile uint8_t SPCR;
+extern volatile uint8_t SPSR;
+extern volatile uint8_t SPDR;
+#define SPR0 0
+#define MSTR 4
+#define SPE 6
+#define SPI2X 0
+#define SPIF 7
+
+extern volatile uint8_t TCCR2A;
+extern volatile uint8_t TCCR2B;
+extern volatile uint8_t TCNT2;
+extern volatile uint8_t TIMSK2;
+#define CS20 0
+#define CS22 2
+#define TOIE2 0
+
+// conversions never complete, ADC_vect runs only when called
+extern volatile uint8_t ADMUX;
+extern volatile uint8_t ADCSRA;
+extern volatile uint8_t ADCSRB;
+extern volatile uint8_t ADCH;
+extern volatile uint8_t DIDR0;
+#define ADLAR 5
+#define REFS0 6
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE 3
+#define ADATE 5
+#define ADSC 6
+#define ADEN 7
+
+// the stack stays at the top of a stretch of memory above a small heap
+extern uint8_t *sim_stack_pointer;
+#define SP ((uintptr_t)sim_stack_pointer)
+
+#define ISR(vector) extern "C" void vector(void)
+
+#define cli()
+#define sei()
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __SIM_AVR_SLEEP_H__
+#define __SIM_AVR_SLEEP_H__
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+
+#include <stdint.h>
+
+// Sleeping skips the virtual clock to the next millisecond (the timer 0
+// interrupt) in idle mode, or to the next input while powered down.
+
+void set_sleep_mode(uint8_t mode);
+void sleep_cpu(void);
+
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_mode() sleep_cpu()
+
+#endif
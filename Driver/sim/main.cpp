@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "sim.h"
+
+#include <EEPROM.h>
+
+#include "Jack.h"
+#include "Capturer.h"
+#include "Messages.h"
+
+extern void setup(void);
+extern void loop(void);
+
+// Replays a trace of input edges against the firmware on a virtual clock.
+//
+// Trace lines: "<ms> <pin> <level>", "<ms> serial <text>" or "<ms> data <hex>",
+// sorted by time, '#' starts a comment. Serial text is fed to the debug serial
+// with a newline, data as bytes (e.g. frames of tools/stream.py --trace).
+//
+// Options:
+//  --until <ms>      replay at least until then
+//  --tick <us>       clock advance per loop while the firmware doesn't sleep
+//  --quiet           don't print the outputs
+//  --serial          copy the debug log to stderr
+//  --costs           charge CPU time for what takes long on the board: 30 us
+//                    per LED shown (APA106 at 800 kHz), 10.4 ms per command to
+//                    the MP3 module (10 bytes at 9600 baud) and, as a rough
+//                    estimate, 10 us per colour computed by FastLED
+//  --eeprom <file>   load and save the EEPROM
+//  --replay <file>   replay captured edges ("<pin> <level> <delta ms>" lines,
+//                    see tools/logdecode.py --edges) instead of the pins
+//  --expect <file>   check the outputs against expected ones, exits with 1 on
+//                    a mismatch (see below)
+//  --tolerance <ms>  how far outputs may be off the expected time, 5 ms
+//
+// State transitions in the log are outputs too ("state <from> <to>"). Expected
+// outputs are lines of the printed outputs, e.g. trimmed from a run known to be
+// good (see sim/fixtures). Every kind of output in the file but frames must
+// match the recorded outputs of that kind one by one, a frame line checks the
+// LEDs at that time only.
+
+namespace {
+
+// records the transitions logged by the firmware as outputs
+void tap(uint8_t data) {
+    // sync, message id, argument length, timestamp, arguments
+    static uint8_t record[5 + 255];
+    static size_t length = 0;
+    if (length == 0 && data != 0xA5) return;
+    record[length++] = data;
+    if (length < 5 || length < 5u + record[2]) return;
+    length = 0;
+    if (record[1] == uint8_t(Message::Transition) && record[2] == 2) {
+        // at the time of the record, the serial may take a while to send it
+        uint16_t stamp = uint16_t(record[3] | (record[4] << 8));
+        uint64_t late = uint64_t(uint16_t(millis() - stamp)) * 1000;
+        uint64_t now = sim::now();
+        sim::record(sim::Output::State, record[5], record[6], now > late ? now - late : 0);
+    }
+}
+
+struct expected_t {
+    double ms;
+    sim::Output output;
+    unsigned target;
+    unsigned long value;
+};
+
+bool parse(const char *line, expected_t& expected) {
+    char name[16];
+    if (sscanf(line, "%lf %15s %u %lu", &expected.ms, name, &expected.target, &expected.value) != 4) {
+        return false;
+    }
+    for (uint8_t output = 0; output <= uint8_t(sim::Output::State); output++) {
+        if (!strcmp(name, sim::outputName(sim::Output(output)))) {
+            expected.output = sim::Output(output);
+            return true;
+        }
+    }
+    return false;
+}
+
+void report(const expected_t& expected, const char *problem) {
+    fprintf(stderr, "expected %.3f %s %u %lu, %s\n", expected.ms, sim::outputName(expected.output),
+        expected.target, expected.value, problem);
+}
+
+// compares the recorded outputs with the expected ones, returns the mismatches
+unsigned check(const std::vector<expected_t>& expectations, double tolerance) {
+    unsigned mismatches = 0;
+    for (uint8_t kind = 0; kind <= uint8_t(sim::Output::State); kind++) {
+        sim::Output output = sim::Output(kind);
+        size_t expectedCount = 0;
+        size_t index = 0;
+        for (const expected_t& expected : expectations) {
+            if (expected.output != output) continue;
+            expectedCount++;
+            char problem[80];
+
+            if (output == sim::Output::Frame) {
+                // the frame last shown by then
+                const sim::event_t *shown = 0;
+                for (size_t i = 0; i < sim::eventCount(); i++) {
+                    const sim::event_t& event = sim::event(i);
+                    if (event.output == output && event.us <= uint64_t((expected.ms + tolerance) * 1000.0)) {
+                        shown = &event;
+                    }
+                }
+                if (!shown || shown->target != expected.target || shown->value != expected.value) {
+                    snprintf(problem, sizeof(problem), "LEDs show %u %lu",
+                        shown ? unsigned(shown->target) : 0, shown ? (unsigned long)shown->value : 0);
+                    report(expected, problem);
+                    mismatches++;
+                }
+                continue;
+            }
+
+            while (index < sim::eventCount() && sim::event(index).output != output) index++;
+            if (index == sim::eventCount()) {
+                report(expected, "missing");
+                mismatches++;
+                continue;
+            }
+            const sim::event_t& event = sim::event(index++);
+            double ms = double(event.us) / 1000.0;
+            if (event.target != expected.target || event.value != expected.value ||
+                ms < expected.ms - tolerance || ms > expected.ms + tolerance) {
+                snprintf(problem, sizeof(problem), "got %.3f %u %lu", ms, unsigned(event.target),
+                    (unsigned long)event.value);
+                report(expected, problem);
+                mismatches++;
+            }
+        }
+        if (output != sim::Output::Frame && expectedCount && sim::count(output) != expectedCount) {
+            fprintf(stderr, "expected %zu %s outputs, got %zu\n", expectedCount, sim::outputName(output),
+                sim::count(output));
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = 0;
+    const char *eeprom = 0;
+    const char *replay = 0;
+    const char *expect = 0;
+    double tolerance = 5;
+    double duration = 0;
+    unsigned tick = 100;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--until") && i + 1 < argc) duration = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--tick") && i + 1 < argc) tick = unsigned(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--quiet")) quiet = true;
+        else if (!strcmp(argv[i], "--serial")) sim::echoSerial(stderr);
+        else if (!strcmp(argv[i], "--costs")) sim::setCosts({ 30, 10417, 10 });
+        else if (!strcmp(argv[i], "--eeprom") && i + 1 < argc) eeprom = argv[++i];
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc) replay = argv[++i];
+        else if (!strcmp(argv[i], "--expect") && i + 1 < argc) expect = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else path = argv[i];
+    }
+
+    sim::reset();
+    sim::setTrace(quiet ? 0 : stdout);
+    sim::tapSerial(tap);
+
+    // eeprom contents persist across runs in a file
+    if (eeprom) {
+        FILE *file = fopen(eeprom, "rb");
+        if (file) {
+            size_t read = fread(sim::eeprom(), 1, E2END + 1, file);
+            (void)read;
+            fclose(file);
+        }
+    }
+
+    FILE *input = path ? fopen(path, "r") : 0;
+    if (path && !input) {
+        perror(path);
+        return 1;
+    }
+
+    // inputs idle high (pull-ups), sensor idle low, setup() keeps these
+    sim::setPin(BUTTON_PIN, 1);
+    sim::setPin(SENSOR_PIN, 0);
+
+    std::vector<Capturer::edge_t> edges;
+    if (replay) {
+        FILE *file = fopen(replay, "r");
+        if (!file) {
+            perror(replay);
+            return 1;
+        }
+        unsigned edgePin, edgeLevel, edgeDelta;
+        while (fscanf(file, "%u %u %u", &edgePin, &edgeLevel, &edgeDelta) == 3) {
+            Capturer::edge_t edge = { uint8_t(edgePin), uint8_t(edgeLevel), uint16_t(edgeDelta) };
+            edges.push_back(edge);
+        }
+        fclose(file);
+        Capturer::replay(edges.data(), uint16_t(edges.size()));
+    }
+
+    setup();
+
+    char line[128];
+    double at = -1;
+    unsigned pin = 0, level = 0;
+    char text[128];
+    bool serial = false;
+    bool data = false;
+    bool pending = false;
+    for (;;) {
+        if (!pending && input) {
+            while (fgets(line, sizeof(line), input)) {
+                if (line[0] == '#' || line[0] == '\n') continue;
+                serial = data = false;
+                if (sscanf(line, "%lf %u %u", &at, &pin, &level) == 3) { pending = true; break; }
+                if (sscanf(line, "%lf serial %126[^\n]", &at, text) == 2) { serial = true; pending = true; break; }
+                if (sscanf(line, "%lf data %126s", &at, text) == 2) { data = true; pending = true; break; }
+            }
+        }
+        double ms = double(sim::now()) / 1000.0;
+        if (pending && at <= ms) {
+            if (serial) {
+                strcat(text, "\n");
+                sim::feedSerial(reinterpret_cast<const uint8_t *>(text), strlen(text));
+            }
+            else if (data) {
+                uint8_t bytes[64];
+                size_t count = 0;
+                unsigned byte;
+                for (const char *hex = text; count < sizeof(bytes) && sscanf(hex, "%2x", &byte) == 1; hex += 2) {
+                    bytes[count++] = uint8_t(byte);
+                }
+                sim::feedSerial(bytes, count);
+            }
+            else {
+                sim::setPin(uint8_t(pin), uint8_t(level));
+            }
+            pending = false;
+            continue;
+        }
+        if (!pending && ms >= duration && !Capturer::isReplaying()) break;
+        if (duration && ms >= duration) break;
+        sim::setAlarm(pending ? uint64_t(at * 1000.0) : duration ? uint64_t(duration * 1000.0) : UINT64_MAX);
+        loop();
+        // a sleeping firmware moves the clock on its own
+        if (!sim::hasSlept()) {
+            sim::advance(tick);
+        }
+    }
+
+    if (eeprom) {
+        FILE *file = fopen(eeprom, "wb");
+        if (file) {
+            fwrite(sim::eeprom(), 1, E2END + 1, file);
+            fclose(file);
+        }
+    }
+
+    fprintf(stderr, "simulated %.3f s, %zu events\n", double(sim::now()) / 1e6, sim::eventCount());
+
+    if (expect) {
+        FILE *file = fopen(expect, "r");
+        if (!file) {
+            perror(expect);
+            return 1;
+        }
+        std::vector<expected_t> expectations;
+        while (fgets(line, sizeof(line), file)) {
+            if (line[0] == '#' || line[0] == '\n') continue;
+            expected_t expected;
+            if (!parse(line, expected)) {
+                fprintf(stderr, "%s: can't parse %s", expect, line);
+                fclose(file);
+                return 1;
+            }
+            expectations.push_back(expected);
+        }
+        fclose(file);
+        unsigned mismatches = check(expectations, tolerance);
+        fprintf(stderr, "%zu outputs expected, %u mismatches\n", expectations.size(), mismatches);
+        if (mismatches) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,571 @@
+#include "sim.h"
+
+#include <vector>
+
+#include <Arduino.h>
+#include <DFMiniMp3.h>
+#include <EEPROM.h>
+#include <FastLED.h>
+#include <PWMServo.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+#include "Monitor.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+uint64_t clock_us;
+
+uint8_t pins[32];
+uint8_t pinModes[32];
+// pins set by the simulation, pull-ups don't override them
+uint32_t driven;
+
+std::vector<sim::event_t> events;
+
+std::vector<uint8_t> serialIn;
+size_t serialInPosition;
+FILE *serialOut;
+// transmit buffer of the serial, drained at the baud rate (instantly before
+// begin()), and when its first byte started
+unsigned long serialBaud;
+uint8_t serialQueued;
+uint64_t serialSent_us;
+void (*serialTap)(uint8_t data);
+
+FILE *trace;
+
+sim::costs_t costs;
+
+uint32_t seed = 1;
+
+uint8_t sleepMode;
+uint64_t alarm_us;
+bool slept;
+// time spent powered down, when millis() stands still
+uint64_t frozen_us;
+int64_t skew_us;
+
+bool watchdogEnabled;
+uint64_t watchdogTimeout;
+uint64_t watchdogFed;
+
+uint8_t eepromCells[E2END + 1];
+uint32_t eepromWrites[E2END + 1];
+
+}
+
+namespace sim {
+
+const char *outputName(Output output) {
+    switch (output) {
+    case Output::Pin: return "pin";
+    case Output::Servo: return "servo";
+    case Output::Volume: return "volume";
+    case Output::Track: return "track";
+    case Output::Stop: return "stop";
+    case Output::Frame: return "frame";
+    case Output::State: return "state";
+    }
+    return "?";
+}
+
+void reset(void) {
+    clock_us = 0;
+    alarm_us = UINT64_MAX;
+    slept = false;
+    frozen_us = 0;
+    skew_us = 0;
+    memset(pins, 0, sizeof(pins));
+    memset(pinModes, 0, sizeof(pinModes));
+    driven = 0;
+    events.clear();
+    serialIn.clear();
+    serialInPosition = 0;
+    serialBaud = 0;
+    serialQueued = 0;
+    seed = 1;
+    memset(eepromCells, 0xFF, sizeof(eepromCells));
+    memset(eepromWrites, 0, sizeof(eepromWrites));
+}
+
+uint64_t now(void) {
+    return clock_us;
+}
+
+void advance(uint64_t us) {
+    clock_us += us;
+    if (watchdogEnabled && clock_us - watchdogFed > watchdogTimeout) {
+        fprintf(stderr, "watchdog bites at %llu us\n", (unsigned long long)clock_us);
+        watchdogFed = clock_us;
+    }
+}
+
+void setSkew(int64_t us) {
+    skew_us = us;
+}
+
+void setAlarm(uint64_t us) {
+    alarm_us = us;
+}
+
+bool hasSlept(void) {
+    bool result = slept;
+    slept = false;
+    return result;
+}
+
+void setCosts(const costs_t& costs) {
+    ::costs = costs;
+}
+
+void setPin(uint8_t pin, uint8_t level) {
+    pins[pin % 32] = level;
+    driven |= 1UL << (pin % 32);
+}
+
+uint8_t getPin(uint8_t pin) {
+    return pins[pin % 32];
+}
+
+void record(Output output, uint16_t target, uint32_t value) {
+    record(output, target, value, clock_us);
+}
+
+void record(Output output, uint16_t target, uint32_t value, uint64_t us) {
+    event_t event = { us, output, target, value };
+    events.push_back(event);
+    if (trace) {
+        fprintf(trace, "%10.3f %-6s %3u %lu\n",
+            double(us) / 1000.0, outputName(output), unsigned(target), (unsigned long)value);
+    }
+}
+
+size_t eventCount(void) {
+    return events.size();
+}
+
+const event_t& event(size_t index) {
+    return events[index];
+}
+
+size_t count(Output output) {
+    size_t n = 0;
+    for (const event_t& event : events) {
+        if (event.output == output) n++;
+    }
+    return n;
+}
+
+void feedSerial(const uint8_t *data, size_t length) {
+    serialIn.insert(serialIn.end(), data, data + length);
+}
+
+void echoSerial(FILE *file) {
+    serialOut = file;
+}
+
+void tapSerial(void (*tap)(uint8_t data)) {
+    serialTap = tap;
+}
+
+void setTrace(FILE *file) {
+    trace = file;
+}
+
+uint8_t *eeprom(void) {
+    return eepromCells;
+}
+
+void eepromWritten(uint16_t address) {
+    eepromWrites[address]++;
+}
+
+uint32_t eepromWriteCount(uint16_t address) {
+    return eepromWrites[address];
+}
+
+void mp3Volume(uint8_t volume) {
+    record(Output::Volume, 0, volume);
+    clock_us += costs.command;
+}
+
+void mp3Play(uint16_t track) {
+    record(Output::Track, 0, track);
+    clock_us += costs.command;
+}
+
+void mp3Stop(void) {
+    record(Output::Stop, 0, 0);
+    clock_us += costs.command;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// registers
+
+volatile uint8_t PCICR;
+volatile uint8_t PCIFR;
+volatile uint8_t PCMSK0;
+volatile uint8_t PCMSK1;
+volatile uint8_t PCMSK2;
+// heap of 256 bytes, 768 free bytes up to the stack. __heap_start names the
+// first byte of the memory, like the symbol of the linker script on the board.
+extern "C" {
+char sim_memory[1024];
+char *__brkval = sim_memory + 256;
+freelist_t *__flp = nullptr;
+}
+extern "C" char __heap_start __attribute__((alias("sim_memory")));
+uint8_t *sim_stack_pointer = reinterpret_cast<uint8_t *>(sim_memory + sizeof(sim_memory));
+
+volatile uint8_t MCUSR;
+
+volatile uint8_t DDRB;
+volatile uint8_t PORTB;
+volatile uint8_t SPCR;
+volatile uint8_t SPSR = _BV(SPIF);
+volatile uint8_t SPDR;
+volatile uint8_t TCCR2A;
+volatile uint8_t TCCR2B;
+volatile uint8_t TCNT2;
+volatile uint8_t TIMSK2;
+volatile uint8_t ADMUX;
+volatile uint8_t ADCSRA;
+volatile uint8_t ADCSRB;
+volatile uint8_t ADCH;
+volatile uint8_t DIDR0;
+
+void set_sleep_mode(uint8_t mode) {
+    sleepMode = mode;
+}
+
+void sleep_cpu() {
+    uint64_t until = (clock_us / 1000 + 1) * 1000;
+    if (sleepMode == SLEEP_MODE_PWR_DOWN && alarm_us != UINT64_MAX) {
+        until = alarm_us;
+    }
+    else if (alarm_us < until) {
+        until = alarm_us;
+    }
+    if (until > clock_us) {
+        if (sleepMode == SLEEP_MODE_PWR_DOWN) {
+            frozen_us += until - clock_us;
+        }
+        sim::advance(until - clock_us);
+    }
+    slept = true;
+}
+volatile uint8_t WDTCSR;
+
+void wdt_enable(uint8_t timeout) {
+    watchdogEnabled = true;
+    watchdogTimeout = 16000ULL << timeout;
+    watchdogFed = clock_us;
+}
+
+void wdt_disable() {
+    watchdogEnabled = false;
+}
+
+void wdt_reset() {
+    watchdogFed = clock_us;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Arduino core
+
+HardwareSerial Serial;
+
+EEPROMClass EEPROM;
+
+unsigned long millis(void) {
+    clock_us += 1;
+    return (unsigned long)((clock_us - frozen_us + skew_us) / 1000);
+}
+
+unsigned long micros(void) {
+    clock_us += 1;
+    return (unsigned long)(clock_us - frozen_us + skew_us);
+}
+
+void delay(unsigned long ms) {
+    clock_us += uint64_t(ms) * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    clock_us += us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    pinModes[pin % 32] = mode;
+    if (mode == INPUT_PULLUP && !(driven & (1UL << (pin % 32)))) pins[pin % 32] = HIGH;
+}
+
+int digitalRead(uint8_t pin) {
+    return pins[pin % 32];
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pins[pin % 32] != value) {
+        pins[pin % 32] = value;
+        if (pin != LED_BUILTIN) sim::record(sim::Output::Pin, pin, value);
+    }
+}
+
+int analogRead(uint8_t pin) {
+    return pins[pin % 32] ? 1023 : 0;
+}
+
+long random(long howbig) {
+    if (howbig == 0) return 0;
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+size_t Print::print(unsigned long n, int base) {
+    char buffer[8 * sizeof(long) + 1];
+    char *s = &buffer[sizeof(buffer) - 1];
+    *s = 0;
+    if (base < 2) base = 10;
+    do { unsigned long m = n; n /= base; char c = char(m - base * n); *--s = c < 10 ? c + '0' : c + 'A' - 10; } while (n);
+    return print(s);
+}
+
+size_t Print::print(long n, int base) {
+    if (n < 0 && base == 10) {
+        return print('-') + print((unsigned long)-n, base);
+    }
+    return print((unsigned long)n, base);
+}
+
+int HardwareSerial::available(void) {
+    return int(serialIn.size() - serialInPosition);
+}
+
+int HardwareSerial::read(void) {
+    if (serialInPosition >= serialIn.size()) return -1;
+    return serialIn[serialInPosition++];
+}
+
+int HardwareSerial::peek(void) {
+    if (serialInPosition >= serialIn.size()) return -1;
+    return serialIn[serialInPosition];
+}
+
+namespace {
+
+// a byte takes 10 bits on the wire
+uint64_t byteTime(void) {
+    return 10000000ULL / serialBaud;
+}
+
+// removes the bytes sent by now from the transmit buffer
+void transmit(void) {
+    if (serialBaud == 0) {
+        serialQueued = 0;
+    }
+    while (serialQueued > 0 && clock_us - serialSent_us >= byteTime()) {
+        serialQueued--;
+        serialSent_us += byteTime();
+    }
+    if (serialQueued == 0) {
+        serialSent_us = clock_us;
+    }
+}
+
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+    serialBaud = baud;
+    serialQueued = 0;
+}
+
+int HardwareSerial::availableForWrite(void) {
+    // a microsecond per call, so waiting for room ends
+    clock_us += 1;
+    transmit();
+    return SERIAL_TX_BUFFER_SIZE - 1 - serialQueued;
+}
+
+void HardwareSerial::flush(void) {
+    transmit();
+    while (serialQueued > 0) {
+        clock_us = serialSent_us + byteTime();
+        transmit();
+    }
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    // like the core, waits while the buffer is full
+    transmit();
+    while (serialQueued >= SERIAL_TX_BUFFER_SIZE - 1) {
+        clock_us = serialSent_us + byteTime();
+        transmit();
+    }
+    if (serialBaud != 0) serialQueued++;
+    if (serialOut) fputc(c, serialOut);
+    if (serialTap) serialTap(c);
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PWMServo
+
+uint8_t PWMServo::attach(int pinArg) {
+    pin = uint8_t(pinArg);
+    return 1;
+}
+
+void PWMServo::write(int angleArg) {
+    angle = uint8_t(angleArg);
+    sim::record(sim::Output::Servo, pin, angle);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FastLED
+
+CFastLED FastLED;
+
+uint8_t scale8(uint8_t i, fract8 scale) {
+    return uint8_t((uint16_t(i) * (1 + uint16_t(scale))) >> 8);
+}
+
+uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return uint8_t(((int(i) * int(scale)) >> 8) + ((i && scale) ? 1 : 0));
+}
+
+uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned t = i + j;
+    return t > 255 ? 255 : uint8_t(t);
+}
+
+uint8_t qsub8(uint8_t i, uint8_t j) {
+    return i > j ? uint8_t(i - j) : 0;
+}
+
+uint8_t random8(void) {
+    return uint8_t(random(256));
+}
+
+uint8_t random8(uint8_t lim) {
+    return uint8_t(random(lim));
+}
+
+uint8_t random8(uint8_t min, uint8_t lim) {
+    return uint8_t(random(min, lim));
+}
+
+uint8_t sin8(uint8_t theta) {
+    static const uint8_t quarter[65] = {
+        128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+        176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+        218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+        245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255, 255
+    };
+    uint8_t q = theta >> 6, i = theta & 63;
+    switch (q) {
+    case 0: return quarter[i];
+    case 1: return quarter[64 - i];
+    case 2: return uint8_t(256 - quarter[i]);
+    default: return uint8_t(256 - quarter[64 - i]);
+    }
+}
+
+uint8_t cubicwave8(uint8_t in) {
+    return ease8InOutCubic(uint8_t(in < 128 ? in * 2 : 255 - (in - 128) * 2));
+}
+
+uint8_t ease8InOutCubic(fract8 i) {
+    uint8_t ii = scale8(i, i);
+    uint8_t iii = scale8(ii, i);
+    uint16_t r1 = (3 * uint16_t(ii)) - (2 * uint16_t(iii));
+    return r1 & 0x100 ? 255 : uint8_t(r1);
+}
+
+uint8_t beat8(uint16_t beats_per_minute, uint32_t timebase) {
+    uint32_t ms = millis() - timebase;
+    return uint8_t((ms * beats_per_minute * 280) >> 16);
+}
+
+uint8_t beatsin8(uint16_t beats_per_minute, uint8_t lowest, uint8_t highest,
+                 uint32_t timebase, uint8_t phase_offset) {
+    uint8_t beat = beat8(beats_per_minute, timebase);
+    uint8_t beatsin = sin8(uint8_t(beat + phase_offset));
+    uint8_t rangewidth = highest - lowest;
+    return uint8_t(lowest + scale8(beatsin, rangewidth));
+}
+
+CRGB HeatColor(uint8_t temperature) {
+    clock_us += costs.colour;
+    uint8_t t192 = scale8_video(temperature, 191);
+    uint8_t heatramp = uint8_t((t192 & 0x3F) << 2);
+    if (t192 & 0x80) return CRGB(255, 255, heatramp);
+    if (t192 & 0x40) return CRGB(255, heatramp, 0);
+    return CRGB(heatramp, 0, 0);
+}
+
+CRGB ColorFromPalette(const CRGBPalette16& pal, uint8_t index, uint8_t brightness, TBlendType blendType) {
+    (void)blendType;
+    clock_us += costs.colour;
+    CRGB color = pal.entries[index >> 4];
+    if (brightness != 255) {
+        color.r = scale8(color.r, brightness);
+        color.g = scale8(color.g, brightness);
+        color.b = scale8(color.b, brightness);
+    }
+    return color;
+}
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    clock_us += costs.colour;
+    uint8_t region = hsv.h / 43, remainder = uint8_t((hsv.h - region * 43) * 6);
+    uint8_t p = scale8(hsv.v, uint8_t(255 - hsv.s));
+    uint8_t q = scale8(hsv.v, uint8_t(255 - scale8(hsv.s, remainder)));
+    uint8_t t = scale8(hsv.v, uint8_t(255 - scale8(hsv.s, uint8_t(255 - remainder))));
+    switch (region) {
+    case 0: rgb = CRGB(hsv.v, t, p); break;
+    case 1: rgb = CRGB(q, hsv.v, p); break;
+    case 2: rgb = CRGB(p, hsv.v, t); break;
+    case 3: rgb = CRGB(p, q, hsv.v); break;
+    case 4: rgb = CRGB(t, p, hsv.v); break;
+    default: rgb = CRGB(hsv.v, p, q); break;
+    }
+}
+
+CRGB& CRGB::nscale8_video(uint8_t scale) {
+    r = scale8_video(r, scale);
+    g = scale8_video(g, scale);
+    b = scale8_video(b, scale);
+    return *this;
+}
+
+void CLEDController::show(const CRGB *data, int nLeds, uint8_t brightness) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < nLeds; i++) {
+        hash = (hash ^ scale8(data[i].r, brightness)) * 16777619u;
+        hash = (hash ^ scale8(data[i].g, brightness)) * 16777619u;
+        hash = (hash ^ scale8(data[i].b, brightness)) * 16777619u;
+    }
+    sim::record(sim::Output::Frame, uint16_t(nLeds), hash);
+    clock_us += uint64_t(costs.led) * nLeds;
+}
+
+void CFastLED::show(uint8_t scale) {
+    if (controller) controller->show(controller->leds, controller->count, scale);
+}
+
+void CFastLED::clear(bool writeData) {
+    if (controller) {
+        memset(static_cast<void *>(controller->leds), 0, sizeof(CRGB) * controller->count);
+        if (writeData) show(0);
+    }
+}
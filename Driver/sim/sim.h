@@ -0,0 +1,69 @@
+#ifndef __SIM_SIM_H__
+#define __SIM_SIM_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Virtual board shared by all fakes. Time only advances when the simulation
+// advances it (or by one microsecond per clock read or poll of the serial, so
+// busy waits terminate).
+
+namespace sim {
+
+// State is recorded by the simulation from the transitions in the log.
+enum class Output : uint8_t { Pin, Servo, Volume, Track, Stop, Frame, State };
+
+struct event_t {
+    uint64_t us;
+    Output output;
+    uint16_t target;
+    uint32_t value;
+};
+
+void reset(void);
+
+const char *outputName(Output output);
+
+uint64_t now(void);
+void advance(uint64_t us);
+// Shifts millis() and micros() against the simulation, for nodes with clocks
+// of their own.
+void setSkew(int64_t us);
+
+// Time of the next input, sleeping ends there at the latest.
+void setAlarm(uint64_t us);
+// true once after the firmware slept
+bool hasSlept(void);
+
+// CPU time the fakes take off the virtual clock in us, none by default: the
+// show per LED, a command to the MP3 module and a colour computed by FastLED.
+struct costs_t {
+    uint16_t led;
+    uint16_t command;
+    uint16_t colour;
+};
+void setCosts(const costs_t& costs);
+
+void setPin(uint8_t pin, uint8_t level);
+uint8_t getPin(uint8_t pin);
+
+void record(Output output, uint16_t target, uint32_t value);
+// for outputs noticed later than they happened
+void record(Output output, uint16_t target, uint32_t value, uint64_t us);
+size_t eventCount(void);
+const event_t& event(size_t index);
+size_t count(Output output);
+
+void feedSerial(const uint8_t *data, size_t length);
+void echoSerial(FILE *file);
+// Passes every byte the firmware writes to the debug serial to tap.
+void tapSerial(void (*tap)(uint8_t data));
+
+void setTrace(FILE *file);
+
+uint8_t *eeprom(void);
+uint32_t eepromWriteCount(uint16_t address);
+
+}
+
+#endif
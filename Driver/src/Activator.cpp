@@ -2,6 +2,8 @@
 
 #include <PWMServo.h>
 
+#include "Tracer.h"
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Activator::Implementation {
@@ -21,6 +23,7 @@ public:
 
     bool release() {
         servo.write(released);
+        TRACE(Released);
         return true;
     }
 
@@ -29,6 +32,16 @@ public:
         return true;
     }
 
+    bool move(uint8_t angle) {
+        servo.write(angle);
+        return true;
+    }
+
+    void setAngles(uint8_t released, uint8_t restrained) {
+        this->released = released;
+        this->restrained = restrained;
+    }
+
 private:
     uint8_t pin;
 
@@ -66,4 +79,12 @@ bool Activator::restrain() {
     return impl->restrain();
 }
 
+bool Activator::move(uint8_t angle) {
+    return impl->move(angle);
+}
+
+void Activator::setAngles(uint8_t released, uint8_t restrained) {
+    impl->setAngles(released, restrained);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,9 @@ public:
 
     bool release(void);
     bool restrain(void);
+    bool move(uint8_t angle);
+
+    void setAngles(uint8_t released, uint8_t restrained);
 
 private:
     Activator(const Activator&);
@@ -0,0 +1,50 @@
+#include "Animations.h"
+
+// Generated by tools/animate.py, do not edit.
+
+// lightning: 30 frames of 12 LEDs, 612 bytes of 1080 (1.8:1)
+const uint8_t lightning_data[] PROGMEM = {
+    0x4B, 0x00, 0x00, 0x00, 0x4B, 0xFF, 0xFF, 0xFF, 0x0B, 0x4B, 0x40, 0x40, 0x50, 0x4B, 0x00, 0x00,
+    0x00, 0x0B, 0x00, 0x80, 0xCC, 0xCC, 0xFF, 0x01, 0x80, 0xCC, 0xCC, 0xFF, 0x01, 0x80, 0xCC, 0xCC,
+    0xFF, 0x01, 0x80, 0xCC, 0xCC, 0xFF, 0x00, 0x45, 0xFF, 0xFF, 0xFF, 0x45, 0x30, 0x30, 0x40, 0x4B,
+    0x00, 0x00, 0x00, 0x0B, 0xC1, 0x07, 0x0C, 0x0C, 0x14, 0x41, 0x03, 0x00, 0x07, 0xC0, 0x0C, 0x14,
+    0x41, 0x03, 0x00, 0x07, 0xC0, 0x0C, 0x14, 0x41, 0x03, 0x00, 0x07, 0xC1, 0x0C, 0x14, 0x07, 0x0C,
+    0xC1, 0x28, 0x0C, 0x2D, 0x14, 0x41, 0x06, 0x01, 0x0F, 0xC0, 0x2D, 0x14, 0x41, 0x06, 0x01, 0x0F,
+    0xC0, 0x2D, 0x14, 0x41, 0x06, 0x01, 0x0F, 0xC1, 0x2D, 0x14, 0x28, 0x0C, 0xC1, 0x07, 0x0C, 0x2D,
+    0x14, 0x41, 0x09, 0x01, 0x16, 0xC0, 0x2D, 0x14, 0x41, 0x09, 0x01, 0x16, 0xC0, 0x2D, 0x14, 0x41,
+    0x09, 0x01, 0x16, 0xC1, 0x2D, 0x14, 0x07, 0x0C, 0xC1, 0x28, 0x0C, 0x2D, 0x14, 0x41, 0x0C, 0x02,
+    0x1E, 0xC0, 0x2D, 0x14, 0x41, 0x0C, 0x02, 0x1E, 0xC0, 0x2D, 0x14, 0x41, 0x0C, 0x02, 0x1E, 0xC1,
+    0x2D, 0x14, 0x28, 0x0C, 0xC1, 0x08, 0x0C, 0x2C, 0x14, 0x41, 0x0F, 0x02, 0x26, 0xC0, 0x2C, 0x14,
+    0x41, 0x0F, 0x02, 0x26, 0xC0, 0x2C, 0x14, 0x41, 0x0F, 0x02, 0x26, 0xC1, 0x2C, 0x14, 0x08, 0x0C,
+    0xC1, 0x27, 0x0C, 0x2D, 0x14, 0x41, 0x12, 0x03, 0x2D, 0xC0, 0x2D, 0x14, 0x41, 0x12, 0x03, 0x2D,
+    0xC0, 0x2D, 0x14, 0x41, 0x12, 0x03, 0x2D, 0xC1, 0x2D, 0x14, 0x27, 0x0C, 0xC1, 0x08, 0x0C, 0x0D,
+    0x14, 0x41, 0x15, 0x03, 0x35, 0xC0, 0x0D, 0x14, 0x41, 0x15, 0x03, 0x35, 0xC0, 0x0D, 0x14, 0x41,
+    0x15, 0x03, 0x35, 0xC1, 0x0D, 0x14, 0x08, 0x0C, 0xC1, 0x28, 0x0C, 0x2D, 0x14, 0x41, 0x18, 0x04,
+    0x3D, 0xC0, 0x2D, 0x14, 0x41, 0x18, 0x04, 0x3D, 0xC0, 0x2D, 0x14, 0x41, 0x18, 0x04, 0x3D, 0xC1,
+    0x2D, 0x14, 0x28, 0x0C, 0xC1, 0x07, 0x0C, 0x2C, 0x14, 0x41, 0x1B, 0x04, 0x44, 0xC0, 0x2C, 0x14,
+    0x41, 0x1B, 0x04, 0x44, 0xC0, 0x2C, 0x14, 0x41, 0x1B, 0x04, 0x44, 0xC1, 0x2C, 0x14, 0x07, 0x0C,
+    0xC1, 0x28, 0x0C, 0x2D, 0x18, 0x41, 0x1E, 0x05, 0x4C, 0xC0, 0x2D, 0x18, 0x41, 0x1E, 0x05, 0x4C,
+    0xC0, 0x2D, 0x18, 0x41, 0x1E, 0x05, 0x4C, 0xC1, 0x2D, 0x18, 0x28, 0x0C, 0xC1, 0x08, 0x0C, 0x2D,
+    0x14, 0x41, 0x21, 0x05, 0x54, 0xC0, 0x2D, 0x14, 0x41, 0x21, 0x05, 0x54, 0xC0, 0x2D, 0x14, 0x41,
+    0x21, 0x05, 0x54, 0xC1, 0x2D, 0x14, 0x08, 0x0C, 0xC1, 0x27, 0x0C, 0x2D, 0x14, 0x41, 0x24, 0x06,
+    0x5B, 0xC0, 0x2D, 0x14, 0x41, 0x24, 0x06, 0x5B, 0xC0, 0x2D, 0x14, 0x41, 0x24, 0x06, 0x5B, 0xC1,
+    0x2D, 0x14, 0x27, 0x0C, 0xC1, 0x08, 0x0C, 0x2C, 0x14, 0x41, 0x27, 0x06, 0x63, 0xC0, 0x2C, 0x14,
+    0x41, 0x27, 0x06, 0x63, 0xC0, 0x2C, 0x14, 0x41, 0x27, 0x06, 0x63, 0xC1, 0x2C, 0x14, 0x08, 0x0C,
+    0xC1, 0x28, 0x0C, 0x0D, 0x14, 0x41, 0x2A, 0x07, 0x6B, 0xC0, 0x0D, 0x14, 0x41, 0x2A, 0x07, 0x6B,
+    0xC0, 0x0D, 0x14, 0x41, 0x2A, 0x07, 0x6B, 0xC1, 0x0D, 0x14, 0x28, 0x0C, 0xC1, 0x07, 0x0C, 0x2D,
+    0x14, 0x41, 0x2D, 0x07, 0x72, 0xC0, 0x2D, 0x14, 0x41, 0x2D, 0x07, 0x72, 0xC0, 0x2D, 0x14, 0x41,
+    0x2D, 0x07, 0x72, 0xC1, 0x2D, 0x14, 0x07, 0x0C, 0xC1, 0x28, 0x0C, 0x2D, 0x14, 0x41, 0x30, 0x08,
+    0x7A, 0xC0, 0x2D, 0x14, 0x41, 0x30, 0x08, 0x7A, 0xC0, 0x2D, 0x14, 0x41, 0x30, 0x08, 0x7A, 0xC1,
+    0x2D, 0x14, 0x28, 0x0C, 0xC1, 0x08, 0x10, 0x2C, 0x14, 0x41, 0x34, 0x08, 0x82, 0xC0, 0x2C, 0x14,
+    0x41, 0x34, 0x08, 0x82, 0xC0, 0x2C, 0x14, 0x41, 0x34, 0x08, 0x82, 0xC1, 0x2C, 0x14, 0x08, 0x10,
+    0xC1, 0x27, 0x0C, 0x2D, 0x14, 0x41, 0x37, 0x09, 0x89, 0xC0, 0x2D, 0x14, 0x41, 0x37, 0x09, 0x89,
+    0xC0, 0x2D, 0x14, 0x41, 0x37, 0x09, 0x89, 0xC1, 0x2D, 0x14, 0x27, 0x0C, 0xC1, 0x08, 0x0C, 0x2D,
+    0x14, 0x41, 0x3A, 0x09, 0x91, 0xC0, 0x2D, 0x14, 0x41, 0x3A, 0x09, 0x91, 0xC0, 0x2D, 0x14, 0x41,
+    0x3A, 0x09, 0x91, 0xC1, 0x2D, 0x14, 0x08, 0x0C, 0xC1, 0x28, 0x0C, 0x2D, 0x18, 0x41, 0x3D, 0x0A,
+    0x99, 0xC0, 0x2D, 0x18, 0x41, 0x3D, 0x0A, 0x99, 0xC0, 0x2D, 0x18, 0x41, 0x3D, 0x0A, 0x99, 0xC1,
+    0x2D, 0x18, 0x28, 0x0C,
+};
+
+const Indicator::animation_t animations[animations_count] PROGMEM = {
+    { lightning_data, 30, 12 },
+};
@@ -0,0 +1,15 @@
+#ifndef __ANIMATIONS_H__
+#define __ANIMATIONS_H__
+
+// Generated by tools/animate.py, do not edit.
+
+#include "Indicator.h"
+
+enum animation_number_t : uint8_t {
+    lightning_animation,
+    animations_count
+};
+
+extern const Indicator::animation_t animations[animations_count] PROGMEM;
+
+#endif
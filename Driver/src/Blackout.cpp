@@ -0,0 +1,35 @@
+#include "Blackout.h"
+
+// 16 MHz / 128
+#define TICK_US 8
+
+namespace {
+
+// latest start of the overflow interrupt in ticks
+volatile uint8_t latest = 0;
+
+}
+
+ISR(TIMER2_OVF_vect) {
+    uint8_t late = TCNT2;
+    if (late > latest) {
+        latest = late;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Blackout::begin() {
+    TCCR2A = 0;
+    TCCR2B = _BV(CS22) | _BV(CS20);
+    TCNT2 = 0;
+    TIMSK2 = _BV(TOIE2);
+}
+
+uint16_t Blackout::longest() {
+    return uint16_t(latest) * TICK_US;
+}
+
+void Blackout::clear() {
+    latest = 0;
+}
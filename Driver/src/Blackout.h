@@ -0,0 +1,21 @@
+#ifndef __BLACKOUT_H__
+#define __BLACKOUT_H__
+
+#include <Arduino.h>
+
+// Measures how long interrupts stay blocked, by LED frames or other interrupt
+// handlers. Timer 2 overflows every 2 ms and its interrupt reads how late it
+// runs, in steps of 8 us up to 2 ms. It samples, so short blackouts are caught
+// over time. Interrupts are global, so the meter is a single static instance.
+
+class Blackout {
+public:
+    // Takes over timer 2.
+    static void begin(void);
+
+    // longest blackout in us since the last clear()
+    static uint16_t longest(void);
+    static void clear(void);
+};
+
+#endif
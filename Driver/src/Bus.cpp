@@ -0,0 +1,415 @@
+#include "Bus.h"
+
+#include <util/crc16.h>
+
+#define SYNC 0x7E
+#define PAYLOAD 4
+// sync, source, type, length and checksum
+#define OVERHEAD 6
+#define ATTEMPTS 3
+#define BEACON_PERIOD 1000
+// cascaded triggers due longer ago than this (ms) are dropped
+#define STALE 1000
+// beacons further off the estimate than this (ms) restart it, the clock of
+// the node jumped (e.g. it was reset)
+#define JUMP 1000
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+enum frame_type_t : uint8_t {
+    beacon_frame,
+    cascade_frame
+};
+
+enum class Receiving : uint8_t {
+    Idle,
+    Source,
+    Type,
+    Length,
+    Payload,
+    ChecksumLow,
+    ChecksumHigh
+};
+
+enum class Sending : uint8_t {
+    Idle,
+    // for a quiet bus and the end of the backoff
+    Waiting,
+    // for the frame to come back
+    Echoing
+};
+
+uint32_t read32(const uint8_t *data) {
+    return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+}
+
+void write32(uint8_t *data, uint32_t value) {
+    data[0] = value;
+    data[1] = value >> 8;
+    data[2] = value >> 16;
+    data[3] = value >> 24;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Bus::Implementation {
+public:
+    Implementation(Stream& serial, uint8_t enable, uint8_t address, unsigned long baud, uint16_t cascade)
+        : serial(serial), enable(enable), address(address), cascade(cascade) {
+
+        // 10 bits per byte
+        byte_us = 10000000UL / baud;
+        // nodes run the same sketch, so random() is the same everywhere
+        seed = 0xACE1 ^ (uint16_t(address) * 0x9E37);
+        clear();
+    }
+
+    bool begin() {
+        digitalWrite(enable, LOW);
+        pinMode(enable, OUTPUT);
+        heard = micros();
+        beacon_at = millis() + next() % BEACON_PERIOD;
+        return true;
+    }
+
+    bool loop() {
+        while (serial.available() > 0) {
+            heard = micros();
+            receive(uint8_t(serial.read()));
+        }
+        transmit();
+        return true;
+    }
+
+    void trigger() {
+        triggered_at = millis();
+        trigger_pending = true;
+    }
+
+    bool isDue() {
+        if (!due_pending) {
+            return false;
+        }
+        int32_t late = millis() - due_at;
+        if (late < 0) {
+            return false;
+        }
+        due_pending = false;
+        return late < STALE;
+    }
+
+    bool offset(uint8_t node, int32_t& offset) {
+        if (node >= Nodes || !(known & (1U << node))) {
+            return false;
+        }
+        offset = estimate(node);
+        return true;
+    }
+
+    statistics_t statistics() {
+        return counters;
+    }
+
+    void clear() {
+        memset(&counters, 0, sizeof(counters));
+    }
+
+private:
+    Stream& serial;
+    uint8_t enable;
+    uint8_t address;
+    uint16_t cascade;
+    uint16_t byte_us;
+
+    Receiving receiving = Receiving::Idle;
+    uint8_t source;
+    uint8_t type;
+    uint8_t length;
+    uint8_t index;
+    uint8_t payload[PAYLOAD];
+    uint16_t checksum;
+    uint16_t received;
+    // micros() of the last byte received
+    uint32_t heard;
+
+    Sending sending = Sending::Idle;
+    uint8_t frame[OVERHEAD + PAYLOAD];
+    uint8_t attempts;
+    uint32_t backoff_until;
+    uint32_t echo_until;
+    bool trigger_pending = false;
+    uint32_t triggered_at;
+    uint32_t beacon_at;
+    uint16_t seed;
+
+    // remote minus own clock per node in ms (modulo 2^32), for the nodes known
+    // from beacons, and the quarter ms on top of it (0 to 3): in whole ms the
+    // filter would stick up to 3 ms behind a clock that drifts
+    int32_t offsets[Nodes];
+    uint8_t quarters[Nodes];
+    uint16_t known = 0;
+
+    bool due_pending = false;
+    uint32_t due_at;
+
+    statistics_t counters;
+
+    uint16_t frame_us(uint8_t length) {
+        return (OVERHEAD + length) * byte_us;
+    }
+
+    // offset of a known node in ms, rounded
+    int32_t estimate(uint8_t node) {
+        return int32_t(uint32_t(offsets[node]) + (quarters[node] >= 2 ? 1 : 0));
+    }
+
+    // xorshift, differs per address
+    uint16_t next(void) {
+        seed ^= seed << 7;
+        seed ^= seed >> 9;
+        seed ^= seed << 8;
+        return seed;
+    }
+
+    // random number of frame times to back off, the range doubles per attempt
+    uint32_t backoff(void) {
+        return uint32_t(next() & ((4U << attempts) - 1)) * frame_us(PAYLOAD);
+    }
+
+    void receive(uint8_t data) {
+        switch (receiving) {
+        case Receiving::Idle:
+            if (data == SYNC) {
+                checksum = 0xFFFF;
+                receiving = Receiving::Source;
+            }
+            return;
+        case Receiving::Source:
+            source = data;
+            receiving = Receiving::Type;
+            break;
+        case Receiving::Type:
+            type = data;
+            receiving = Receiving::Length;
+            break;
+        case Receiving::Length:
+            if (data > PAYLOAD) {
+                receiving = Receiving::Idle;
+                corrupted();
+                return;
+            }
+            length = data;
+            index = 0;
+            receiving = length > 0 ? Receiving::Payload : Receiving::ChecksumLow;
+            break;
+        case Receiving::Payload:
+            payload[index++] = data;
+            if (index == length) {
+                receiving = Receiving::ChecksumLow;
+            }
+            break;
+        case Receiving::ChecksumLow:
+            received = data;
+            receiving = Receiving::ChecksumHigh;
+            return;
+        case Receiving::ChecksumHigh:
+            received |= uint16_t(data) << 8;
+            receiving = Receiving::Idle;
+            if (received != checksum) {
+                corrupted();
+            }
+            else if (source == address) {
+                echoed();
+            }
+            else {
+                handle();
+            }
+            return;
+        }
+        checksum = _crc16_update(checksum, data);
+    }
+
+    void corrupted() {
+        counters.corrupted++;
+        if (sending == Sending::Echoing) {
+            collided();
+        }
+    }
+
+    void handle() {
+        if (source >= Nodes || length != PAYLOAD) {
+            return;
+        }
+        counters.received++;
+
+        // the frame was stamped when it was written, its last byte arrived a
+        // frame time later
+        uint32_t now = millis();
+        uint32_t sent = now - frame_us(length) / 1000;
+        uint32_t remote = read32(payload);
+
+        switch (type) {
+        case beacon_frame: {
+            int32_t sample = int32_t(remote - sent);
+            int32_t difference = int32_t(uint32_t(sample) - uint32_t(offsets[source]));
+            if ((known & (1U << source)) && difference < JUMP && difference > -JUMP) {
+                // a quarter of the way to the sample, in quarter ms
+                int16_t step = (int16_t(difference) * 4 - quarters[source]) / 4;
+                int16_t total = quarters[source] + step;
+                // floored, the quarters stay 0 to 3
+                int16_t whole = total >= 0 ? total / 4 : -((3 - total) / 4);
+                offsets[source] = int32_t(uint32_t(offsets[source]) + uint32_t(int32_t(whole)));
+                quarters[source] = uint8_t(total - whole * 4);
+            }
+            else {
+                offsets[source] = sample;
+                quarters[source] = 0;
+                known |= 1U << source;
+            }
+            break;
+        }
+        case cascade_frame: {
+            uint32_t at = (known & (1U << source)) ? remote - uint32_t(estimate(source)) : sent;
+            uint8_t distance = source > address ? source - address : address - source;
+            uint32_t due = at + uint32_t(distance) * cascade;
+            // of cascades at once, the nearest one leads
+            if (!due_pending || int32_t(due - due_at) < 0) {
+                due_at = due;
+                due_pending = true;
+            }
+            break;
+        }
+        }
+    }
+
+    void transmit() {
+        uint32_t now = micros();
+        switch (sending) {
+        case Sending::Echoing:
+            if (int32_t(now - echo_until) > 0) {
+                collided();
+            }
+            return;
+        case Sending::Idle:
+            if (trigger_pending) {
+                frame[2] = cascade_frame;
+            }
+            else if (int32_t(millis() - beacon_at) >= 0) {
+                frame[2] = beacon_frame;
+                beacon_at = millis() + BEACON_PERIOD + next() % (BEACON_PERIOD / 8);
+            }
+            else {
+                return;
+            }
+            attempts = 0;
+            backoff_until = now;
+            sending = Sending::Waiting;
+            break;
+        case Sending::Waiting:
+            break;
+        }
+
+        // carrier sense: no frame on the way and two byte times of silence
+        if (receiving != Receiving::Idle || int32_t(now - backoff_until) < 0 || now - heard < 2U * byte_us) {
+            return;
+        }
+        send();
+    }
+
+    void send() {
+        frame[0] = SYNC;
+        frame[1] = address;
+        frame[3] = PAYLOAD;
+        write32(&frame[4], frame[2] == cascade_frame ? triggered_at : millis());
+        uint16_t crc = 0xFFFF;
+        for (uint8_t i = 1; i < 4 + PAYLOAD; i++) {
+            crc = _crc16_update(crc, frame[i]);
+        }
+        frame[4 + PAYLOAD] = crc;
+        frame[5 + PAYLOAD] = crc >> 8;
+
+        digitalWrite(enable, HIGH);
+        serial.write(frame, sizeof(frame));
+        attempts++;
+        // the echo is read within the next loops
+        echo_until = micros() + frame_us(PAYLOAD) + 2000;
+        sending = Sending::Echoing;
+    }
+
+    void echoed() {
+        if (sending != Sending::Echoing || type != frame[2]) {
+            return;
+        }
+        digitalWrite(enable, LOW);
+        sending = Sending::Idle;
+        counters.sent++;
+        if (type == cascade_frame) {
+            trigger_pending = false;
+            uint16_t latency = millis() - triggered_at;
+            if (latency > counters.latency) {
+                counters.latency = latency;
+            }
+        }
+    }
+
+    void collided() {
+        digitalWrite(enable, LOW);
+        counters.collisions++;
+        if (attempts >= ATTEMPTS) {
+            counters.lost++;
+            if (frame[2] == cascade_frame) {
+                trigger_pending = false;
+            }
+            sending = Sending::Idle;
+            return;
+        }
+        backoff_until = micros() + backoff();
+        sending = Sending::Waiting;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Bus::Bus(Stream& serial, uint8_t enable, uint8_t address, unsigned long baud, uint16_t cascade)
+    : impl(new Implementation(serial, enable, address, baud, cascade)) {
+}
+
+Bus::~Bus() {
+    delete impl;
+}
+
+bool Bus::begin() {
+    return impl->begin();
+}
+
+bool Bus::loop() {
+    return impl->loop();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Bus::trigger() {
+    impl->trigger();
+}
+
+bool Bus::isDue() {
+    return impl->isDue();
+}
+
+bool Bus::offset(uint8_t node, int32_t& offset) {
+    return impl->offset(node, offset);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Bus::statistics_t Bus::statistics() {
+    return impl->statistics();
+}
+
+void Bus::clear() {
+    impl->clear();
+}
@@ -0,0 +1,66 @@
+#ifndef __BUS_H__
+#define __BUS_H__
+
+#include <Arduino.h>
+
+// Links the Jacks along a path over a half-duplex RS-485 bus (a transceiver
+// on the serial, its driver enabled by a pin). A Jack triggered by its own
+// sensor broadcasts when, the others follow delayed by the cascade time per
+// address between them, so the scare runs along the path. Every Jack
+// broadcasts its clock about once a second and the others estimate its
+// offset from these beacons, so cascades land on time in their own clocks.
+//
+// Frame: 0x7E, source address, type, payload length, payload, CRC-16
+// (MODBUS, little endian) from source to payload. Transceivers hear their
+// own transmissions: a frame that doesn't come back intact collided and is
+// sent again after a random backoff, up to three times. Nobody sends while
+// bytes are on the bus. This bounds the time from trigger() to the frame on
+// the bus to about 40 frame times at most.
+
+class Bus {
+    class Implementation;
+
+public:
+    // addresses 1 to Nodes - 1
+    enum { Nodes = 16 };
+
+    struct statistics_t {
+        uint16_t sent;
+        uint16_t collisions;
+        uint16_t received;
+        uint16_t corrupted;
+        // frames given up after the last attempt collided
+        uint16_t lost;
+        // longest ms from trigger() until the frame made it onto the bus
+        uint16_t latency;
+    };
+
+    // The serial has to run at baud, which times the frames. cascade: ms
+    // between the triggers of neighbouring addresses.
+    Bus(Stream& serial, uint8_t enable, uint8_t address, unsigned long baud, uint16_t cascade);
+    ~Bus();
+
+    bool begin(void);
+    bool loop(void);
+
+    // Broadcasts that this Jack was triggered just now.
+    void trigger(void);
+    // true once when the cascaded trigger of another Jack is due
+    bool isDue(void);
+
+    // Estimated ms to add to the own clock for the clock of the node, false
+    // until a beacon of the node was received.
+    bool offset(uint8_t node, int32_t& offset);
+
+    // since the last clear()
+    statistics_t statistics(void);
+    void clear(void);
+
+private:
+    Bus(const Bus&);
+    Bus& operator=(const Bus&);
+
+    Implementation *impl;
+};
+
+#endif
@@ -1,15 +1,16 @@
 #include "Button.h"
 
+#include "Timer.h"
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Button::Implementation {
 public:
-    Implementation(uint8_t pin, PullUp enablePullUp, uint32_t debounceTime)
+    Implementation(uint8_t pin, PullUp enablePullUp, uint16_t debounceTime)
         : pin(pin), pinPullUp(bool(enablePullUp)), debounceTime(debounceTime) {
+        reader = digitalRead;
         state = false;
-        stateMillis = millis();
         stateChanged = false;
-        stateChangedMillis = stateMillis;
         lastState = state;
     }
 
@@ -21,26 +22,26 @@ public:
             pinMode(pin, INPUT);
         }
 
-        state = !(digitalRead(pin) == HIGH);
+        state = !(reader(pin) == HIGH);
+        debounce.start(debounceTime);
 
         return true;
     }
 
     bool read(void) {
-        uint32_t ms = millis();
-        if (stateMillis - stateChangedMillis >= debounceTime) {
+        // ignores the pin until it settled after a change
+        if (!debounce.isRunning()) {
             lastState = state;
 
-            state = !(digitalRead(pin) == HIGH);
+            state = !(reader(pin) == HIGH);
             stateChanged = (state != lastState);
             if (stateChanged) {
-                stateChangedMillis = ms;
+                debounce.start(debounceTime);
             }
         }
         else {
             stateChanged = false;
         }
-        stateMillis = ms;
         return state;
     }
 
@@ -60,34 +61,39 @@ public:
         return !state && stateChanged;
     }
 
-    bool pressedFor(uint32_t ms) {
-        return (state && stateMillis - stateChangedMillis >= ms);
+    bool pressedFor(uint16_t ms) {
+        return (state && debounce.elapsed() >= ms);
+    }
+
+    bool releasedFor(uint16_t ms) {
+        return (!state && debounce.elapsed() >= ms);
     }
 
-    bool releasedFor(uint32_t ms) {
-        return (!state && stateMillis - stateChangedMillis >= ms);
+    void setDebounceTime(uint16_t debounceTime) {
+        this->debounceTime = debounceTime;
     }
 
-    uint32_t lastChange(void) {
-        return stateChangedMillis;
+    void setReader(reader_t reader) {
+        this->reader = reader;
     }
 
 private:
     uint8_t pin;
     uint8_t pinPullUp;
-    uint32_t debounceTime;
+    uint16_t debounceTime;
+    reader_t reader;
 
     bool state;
     bool stateChanged;
-    uint32_t stateMillis;
-    uint32_t stateChangedMillis;
+    // started at each change
+    Timer debounce;
 
     bool lastState;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-Button::Button(uint8_t pin, PullUp enablePullUp, uint32_t debounceTime)
+Button::Button(uint8_t pin, PullUp enablePullUp, uint16_t debounceTime)
     : impl(new Implementation(pin, enablePullUp, debounceTime)) {
 }
 
@@ -119,16 +125,20 @@ bool Button::wasReleased() {
     return impl->wasReleased();
 }
 
-bool Button::pressedFor(uint32_t ms) {
+bool Button::pressedFor(uint16_t ms) {
     return impl->pressedFor(ms);
 }
 
-bool Button::releasedFor(uint32_t ms) {
+bool Button::releasedFor(uint16_t ms) {
     return impl->releasedFor(ms);
 }
 
-uint32_t Button::lastChange() {
-    return impl->lastChange();
+void Button::setDebounceTime(uint16_t debounceTime) {
+    impl->setDebounceTime(debounceTime);
+}
+
+void Button::setReader(reader_t reader) {
+    impl->setReader(reader);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
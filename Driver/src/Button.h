@@ -9,7 +9,10 @@ class Button {
 public:
     enum class PullUp : bool { Disable, Enable };
 
-    Button(uint8_t pin, PullUp enablePullUp, uint32_t debounceTime);
+    // reads the level of a pin, digitalRead by default
+    typedef int (*reader_t)(uint8_t pin);
+
+    Button(uint8_t pin, PullUp enablePullUp, uint16_t debounceTime);
     ~Button();
 
     bool begin(void);
@@ -19,9 +22,12 @@ public:
     bool isReleased(void);
     bool wasPressed(void);
     bool wasReleased(void);
-    bool pressedFor(uint32_t ms);
-    bool releasedFor(uint32_t ms);
-    uint32_t lastChange(void);
+    // limited to a minute
+    bool pressedFor(uint16_t ms);
+    bool releasedFor(uint16_t ms);
+
+    void setDebounceTime(uint16_t debounceTime);
+    void setReader(reader_t reader);
 
 private:
     Button(const Button&);
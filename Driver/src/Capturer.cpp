@@ -0,0 +1,111 @@
+#include "Capturer.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// levels and pins as bits, pins above 31 are neither captured nor replayed
+typedef uint32_t pins_t;
+
+#define PIN_BIT(pin) (pins_t(1) << (pin))
+
+Capturer::sink_t sink = nullptr;
+// pins read since capturing started and their last levels
+pins_t captured;
+pins_t captured_levels;
+uint32_t captured_ms;
+
+const Capturer::edge_t *edges = nullptr;
+uint16_t edges_count;
+uint16_t edges_next;
+uint32_t replayed_ms;
+// pins with edges and their levels so far
+pins_t replayed;
+pins_t replayed_levels;
+
+void emit(uint8_t pin, uint8_t level) {
+    uint32_t ms = millis();
+    // long pauses are split into gaps
+    while (ms - captured_ms > 0xFFFF) {
+        captured_ms += 0xFFFF;
+        Capturer::edge_t gap = { Capturer::Gap, 0, 0xFFFF };
+        sink(gap);
+    }
+    Capturer::edge_t edge = { pin, level, uint16_t(ms - captured_ms) };
+    captured_ms = ms;
+    sink(edge);
+}
+
+void advance() {
+    uint32_t ms = millis();
+    while (edges_next < edges_count && ms - replayed_ms >= edges[edges_next].delta) {
+        const Capturer::edge_t& edge = edges[edges_next++];
+        replayed_ms += edge.delta;
+        if (edge.pin == Capturer::Gap || edge.pin >= 32) {
+            continue;
+        }
+        replayed |= PIN_BIT(edge.pin);
+        if (edge.level) {
+            replayed_levels |= PIN_BIT(edge.pin);
+        }
+        else {
+            replayed_levels &= ~PIN_BIT(edge.pin);
+        }
+    }
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Capturer::read(uint8_t pin) {
+    int level;
+    if (edges && pin < 32) {
+        advance();
+        level = (replayed & PIN_BIT(pin)) ? ((replayed_levels & PIN_BIT(pin)) ? HIGH : LOW) : digitalRead(pin);
+    }
+    else {
+        level = digitalRead(pin);
+    }
+
+    if (sink && pin < 32) {
+        bool high = (level == HIGH);
+        if (!(captured & PIN_BIT(pin)) || bool(captured_levels & PIN_BIT(pin)) != high) {
+            captured |= PIN_BIT(pin);
+            if (high) {
+                captured_levels |= PIN_BIT(pin);
+            }
+            else {
+                captured_levels &= ~PIN_BIT(pin);
+            }
+            emit(pin, high);
+        }
+    }
+    return level;
+}
+
+void Capturer::capture(sink_t sink) {
+    ::sink = sink;
+    captured = 0;
+    captured_levels = 0;
+    captured_ms = millis();
+}
+
+bool Capturer::isCapturing() {
+    return sink != nullptr;
+}
+
+void Capturer::replay(const edge_t *edges, uint16_t count) {
+    ::edges = edges;
+    edges_count = count;
+    edges_next = 0;
+    replayed_ms = millis();
+    replayed = 0;
+    replayed_levels = 0;
+}
+
+bool Capturer::isReplaying() {
+    return edges != nullptr && edges_next < edges_count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,40 @@
+#ifndef __CAPTURER_H__
+#define __CAPTURER_H__
+
+#include <Arduino.h>
+
+// Captures the input edges the driver sees and replays them. Capturer::read
+// stands in for digitalRead in the inputs: while capturing every change of a
+// pin is handed to a sink (e.g. the debug log), while replaying the levels of
+// the replayed pins come from the edges instead of the pins. The inputs are
+// spread over several modules, so the capturer is a single static instance.
+
+class Capturer {
+public:
+    // pin of a record which only carries time
+    enum { Gap = 0xFF };
+
+    struct edge_t {
+        uint8_t pin;
+        uint8_t level;
+        // milliseconds since the previous edge
+        uint16_t delta;
+    };
+
+    typedef void (*sink_t)(const edge_t& edge);
+
+    // Reads a pin like digitalRead.
+    static int read(uint8_t pin);
+
+    // Hands every edge to the sink, starting with the levels of the pins at
+    // their next read. nullptr stops capturing.
+    static void capture(sink_t sink);
+    static bool isCapturing(void);
+
+    // Replays the edges from now on, the array has to stay valid. Pins
+    // without edges are still read.
+    static void replay(const edge_t *edges, uint16_t count);
+    static bool isReplaying(void);
+};
+
+#endif
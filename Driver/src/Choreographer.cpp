@@ -0,0 +1,137 @@
+#include "Choreographer.h"
+
+#include "Animations.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Choreographer::Implementation {
+public:
+    Implementation(Activator **activators, uint8_t count, Enunciator& enunciator, Indicator& indicator)
+        : activators(activators), count(count), enunciator(enunciator), indicator(indicator) {
+        timeline = 0;
+    }
+
+    bool begin() {
+        return true;
+    }
+
+    bool loop() {
+        // only the due cues are looked at, so a tick costs the same
+        // regardless of the length of the timeline; cues at the same time
+        // fire together
+        while (timeline != 0 && uint16_t(millis() - start) >= next.at) {
+            act(next);
+            if (next.action == Action::End) {
+                timeline = 0;
+            }
+            else {
+                fetch();
+            }
+        }
+        return true;
+    }
+
+    void perform(const cue_t *timeline) {
+        this->timeline = timeline;
+        start = millis();
+        fetch();
+    }
+
+    void stop() {
+        timeline = 0;
+    }
+
+    bool isPerforming() {
+        return timeline != 0;
+    }
+
+private:
+    Activator **activators;
+    uint8_t count;
+
+    Enunciator& enunciator;
+    Indicator& indicator;
+
+    const cue_t *timeline;
+    uint32_t start;
+
+    cue_t next;
+
+    void fetch() {
+        memcpy_P(&next, timeline++, sizeof(cue_t));
+    }
+
+    void act(const cue_t& cue) {
+        switch (cue.action) {
+        case Action::Release:
+            if (cue.actor < count) activators[cue.actor]->release();
+            break;
+        case Action::Restrain:
+            if (cue.actor < count) activators[cue.actor]->restrain();
+            break;
+        case Action::Move:
+            if (cue.actor < count) activators[cue.actor]->move(cue.value);
+            break;
+        case Action::Laughout:
+            enunciator.laughout();
+            break;
+        case Action::HalloweenSong:
+            enunciator.halloween_song();
+            break;
+        case Action::Silence:
+            enunciator.turnOff();
+            break;
+        case Action::LightUp:
+            indicator.lightUp();
+            break;
+        case Action::DanceIn:
+            indicator.danceIn();
+            break;
+        case Action::Play:
+            if (cue.value < animations_count) indicator.play(&animations[cue.value]);
+            break;
+        case Action::Listen:
+            indicator.listen();
+            break;
+        case Action::Darken:
+            indicator.turnOff();
+            break;
+        case Action::End:
+            break;
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Choreographer::Choreographer(Activator **activators, uint8_t count, Enunciator& enunciator, Indicator& indicator)
+    : impl(new Implementation(activators, count, enunciator, indicator)) {
+}
+
+Choreographer::~Choreographer() {
+    delete impl;
+}
+
+bool Choreographer::begin() {
+    return impl->begin();
+}
+
+bool Choreographer::loop() {
+    return impl->loop();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Choreographer::perform(const cue_t *timeline) {
+    impl->perform(timeline);
+}
+
+void Choreographer::stop() {
+    impl->stop();
+}
+
+bool Choreographer::isPerforming() {
+    return impl->isPerforming();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,60 @@
+#ifndef __CHOREOGRAPHER_H__
+#define __CHOREOGRAPHER_H__
+
+#include <Arduino.h>
+
+#include "Activator.h"
+#include "Enunciator.h"
+#include "Indicator.h"
+
+class Choreographer {
+    class Implementation;
+
+public:
+    enum class Action : uint8_t {
+        End,
+        // servos, addressed by actor index
+        Release,
+        Restrain,
+        Move,
+        // audio track
+        Laughout,
+        HalloweenSong,
+        Silence,
+        // led effects
+        LightUp,
+        DanceIn,
+        Play,       // value is the number of the animation
+        Listen,
+        Darken
+    };
+
+    // A cue fires one action at a time offset from the start of a performance.
+    // Timelines are arrays of cues ordered by time, terminated by an End cue
+    // and stored in PROGMEM.
+    struct cue_t {
+        uint16_t at;
+        Action action;
+        uint8_t actor;
+        uint8_t value;
+    };
+
+    Choreographer(Activator **activators, uint8_t count, Enunciator& enunciator, Indicator& indicator);
+    ~Choreographer();
+
+    bool begin(void);
+    bool loop(void);
+
+    void perform(const cue_t *timeline);
+    void stop(void);
+
+    bool isPerforming(void);
+
+private:
+    Choreographer(const Choreographer&);
+    Choreographer& operator=(const Choreographer&);
+
+    Implementation *impl;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "Configurator.h"
+
+#include <EEPROM.h>
+#include <stddef.h>
+#include <util/crc16.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct field_t {
+    char name[18];
+    uint8_t offset;
+    uint8_t size;
+    uint16_t minimum;
+    uint16_t maximum;
+};
+
+#define FIELD(name, minimum, maximum) \
+    { #name, offsetof(configuration_t, name), sizeof(configuration_t::name), minimum, maximum }
+
+const field_t fields[Configurator::Fields] PROGMEM = {
+    FIELD(volume,            0, 30),
+    FIELD(brightness,        0, 255),
+    FIELD(button_debounce,   0, 255),
+    FIELD(receptor_debounce, 0, 255),
+    FIELD(servo_released,    0, 180),
+    FIELD(servo_restrained,  0, 180),
+    FIELD(clear_time,        0, 60000),
+    FIELD(perform_time,      0, 60000),
+    FIELD(hold_time,         0, 60000),
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Configurator::Implementation {
+public:
+    Implementation(configuration_t& configuration, const configuration_t *defaults, uint16_t address)
+        : configuration(configuration), defaults(defaults), address(address) {
+        memcpy_P(&configuration, defaults, sizeof(configuration_t));
+    }
+
+    bool begin() {
+        configuration_t stored;
+        EEPROM.get(address, stored);
+        if (stored.version != Version || stored.checksum != checksum(stored)) {
+            reset();
+            return false;
+        }
+        configuration = stored;
+        return true;
+    }
+
+    Field find(const char *name) {
+        for (uint8_t index = 0; index < Fields; index++) {
+            if (strcmp_P(name, fields[index].name) == 0) {
+                return Field(index);
+            }
+        }
+        return Fields;
+    }
+
+    uint16_t get(Field field) {
+        if (field >= Fields) {
+            return 0;
+        }
+        uint8_t *value = reinterpret_cast<uint8_t *>(&configuration) + pgm_read_byte(&fields[field].offset);
+        if (pgm_read_byte(&fields[field].size) == 1) {
+            return *value;
+        }
+        return *reinterpret_cast<uint16_t *>(value);
+    }
+
+    bool set(Field field, uint16_t value) {
+        if (field >= Fields) {
+            return false;
+        }
+        if (value < pgm_read_word(&fields[field].minimum) || value > pgm_read_word(&fields[field].maximum)) {
+            return false;
+        }
+        uint8_t *target = reinterpret_cast<uint8_t *>(&configuration) + pgm_read_byte(&fields[field].offset);
+        if (pgm_read_byte(&fields[field].size) == 1) {
+            *target = value;
+        }
+        else {
+            *reinterpret_cast<uint16_t *>(target) = value;
+        }
+        return true;
+    }
+
+    void save() {
+        configuration.version = Version;
+        configuration.checksum = checksum(configuration);
+        EEPROM.put(address, configuration);
+    }
+
+    void reset() {
+        memcpy_P(&configuration, defaults, sizeof(configuration_t));
+        configuration.version = Version;
+    }
+
+private:
+    configuration_t& configuration;
+    const configuration_t *defaults;
+    uint16_t address;
+
+    static uint8_t checksum(const configuration_t& configuration) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&configuration);
+        uint8_t crc = 0;
+        for (uint8_t index = 0; index < offsetof(configuration_t, checksum); index++) {
+            crc = _crc8_ccitt_update(crc, bytes[index]);
+        }
+        return crc;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Configurator::Configurator(configuration_t& configuration, const configuration_t *defaults, uint16_t address)
+    : impl(new Implementation(configuration, defaults, address)) {
+}
+
+Configurator::~Configurator() {
+    delete impl;
+}
+
+bool Configurator::begin() {
+    return impl->begin();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Configurator::Field Configurator::find(const char *name) {
+    return impl->find(name);
+}
+
+uint16_t Configurator::get(Field field) {
+    return impl->get(field);
+}
+
+bool Configurator::set(Field field, uint16_t value) {
+    return impl->set(field, value);
+}
+
+void Configurator::save() {
+    impl->save();
+}
+
+void Configurator::reset() {
+    impl->reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
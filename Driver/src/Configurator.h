@@ -0,0 +1,71 @@
+#ifndef __CONFIGURATOR_H__
+#define __CONFIGURATOR_H__
+
+#include <Arduino.h>
+
+// Settings which can be changed at runtime. Read them straight from the
+// struct, the configurator only loads, stores and edits it.
+struct configuration_t {
+    uint8_t version;
+    uint8_t volume;
+    uint8_t brightness;
+    uint8_t button_debounce;
+    uint8_t receptor_debounce;
+    uint8_t servo_released;
+    uint8_t servo_restrained;
+    // ms the sensor has to be clear before Jack gets equipped
+    uint16_t clear_time;
+    // ms Jack performs after being triggered
+    uint16_t perform_time;
+    // ms the button has to be held to equip Jack right away
+    uint16_t hold_time;
+    uint8_t checksum;
+};
+
+class Configurator {
+    class Implementation;
+
+public:
+    // in the order of the field names, see also Messages.h
+    enum Field : uint8_t {
+        Volume,
+        Brightness,
+        ButtonDebounce,
+        ReceptorDebounce,
+        ServoReleased,
+        ServoRestrained,
+        ClearTime,
+        PerformTime,
+        HoldTime,
+
+        Fields
+    };
+
+    enum { Version = 1 };
+
+    // defaults are stored in PROGMEM
+    Configurator(configuration_t& configuration, const configuration_t *defaults, uint16_t address);
+    ~Configurator();
+
+    // Loads the configuration from EEPROM, falls back to the defaults if the
+    // stored one is corrupted or of another version. Returns false then.
+    bool begin(void);
+
+    // returns Fields for unknown names
+    Field find(const char *name);
+
+    uint16_t get(Field field);
+    // returns false if the value is out of range
+    bool set(Field field, uint16_t value);
+
+    void save(void);
+    void reset(void);
+
+private:
+    Configurator(const Configurator&);
+    Configurator& operator=(const Configurator&);
+
+    Implementation *impl;
+};
+
+#endif
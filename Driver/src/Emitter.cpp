@@ -0,0 +1,63 @@
+#include "Emitter.h"
+
+// nibbles of two bits, the first bit in the high nibble
+const uint8_t patterns[4] PROGMEM = { 0x88, 0x8E, 0xE8, 0xEE };
+
+namespace {
+
+uint8_t *encode(uint8_t *output, uint8_t color) {
+    *output++ = pgm_read_byte(&patterns[color >> 6]);
+    *output++ = pgm_read_byte(&patterns[(color >> 4) & 0x03]);
+    *output++ = pgm_read_byte(&patterns[(color >> 2) & 0x03]);
+    *output++ = pgm_read_byte(&patterns[color & 0x03]);
+    return output;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Emitter::Emitter(uint8_t count)
+    : buffer(new uint8_t[count * 12]), size(count * 12) {
+}
+
+Emitter::~Emitter() {
+    delete[] buffer;
+}
+
+// master at F_CPU / 8, MOSI idles low. SS (pin 10) has to stay an output or
+// the SPI falls back to slave when it is pulled low. The SPI is only enabled
+// while a frame goes out, SCK is the built-in LED (pin 13) which signals a
+// crash in between.
+void Emitter::init() {
+    PORTB &= ~_BV(PORTB3);
+    DDRB |= _BV(DDB2) | _BV(DDB3) | _BV(DDB5);
+    SPCR = _BV(MSTR) | _BV(SPR0);
+    SPSR |= _BV(SPI2X);
+}
+
+void Emitter::showPixels(PixelController<GRB>& pixels) {
+    uint8_t *end = buffer;
+    while (pixels.has(1) && end < buffer + size) {
+        end = encode(end, pixels.loadAndScale0());
+        end = encode(end, pixels.loadAndScale1());
+        end = encode(end, pixels.loadAndScale2());
+        pixels.advanceData();
+        pixels.stepDithering();
+    }
+    if (end == buffer) {
+        return;
+    }
+
+    SPCR |= _BV(SPE);
+    const uint8_t *next = buffer;
+    SPDR = *next++;
+    while (next < end) {
+        uint8_t data = *next++;
+        while (!(SPSR & _BV(SPIF)));
+        SPDR = data;
+    }
+    while (!(SPSR & _BV(SPIF)));
+    // hands pin 13 back to the port, MOSI falls back to its low level
+    SPCR &= ~_BV(SPE);
+}
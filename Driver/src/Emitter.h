@@ -0,0 +1,32 @@
+#ifndef __EMITTER_H__
+#define __EMITTER_H__
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// FastLED controller for APA106 LEDs on the hardware SPI, the alternative to
+// the clockless controller, which keeps interrupts disabled while it bit-bangs
+// a frame. Each bit of a color becomes a nibble on MOSI at 2 MHz, a high pulse
+// of 0.5 us (0) or 1.5 us (1) in a period of 2 us. A frame is encoded into a
+// buffer of 12 bytes per LED and streamed with interrupts enabled: the nibbles
+// end low, so an interrupt only stretches the gap between two bits. Gaps
+// longer than the reset time of the LEDs (50 us, e.g. a byte received by
+// SoftwareSerial) latch a torn frame, the next frame repaints it.
+
+class Emitter : public CPixelLEDController<GRB> {
+public:
+    Emitter(uint8_t count);
+    ~Emitter();
+
+    virtual void init(void);
+    virtual void showPixels(PixelController<GRB>& pixels);
+
+private:
+    Emitter(const Emitter&);
+    Emitter& operator=(const Emitter&);
+
+    uint8_t *buffer;
+    uint16_t size;
+};
+
+#endif
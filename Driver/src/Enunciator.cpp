@@ -1,6 +1,9 @@
 #include "Enunciator.h"
 
 #include <DFMiniMp3.h>
+#include <avr/wdt.h>
+
+#include "Tracer.h"
 
 #define MP3_OVERTURE 1
 #define MP3_LAUGHOUT 2
@@ -49,6 +52,11 @@ public:
         mp3.stop();
     }
 
+    void setVolume(uint8_t volume) {
+        // takes effect with the next track
+        this->volume = volume;
+    }
+
     void play(uint8_t track, uint16_t wait_ms, uint8_t track_volume = 30) {
         uint16_t volume = (this->volume * track_volume) / 30;
         mp3.setVolume(volume);
@@ -56,11 +64,17 @@ public:
         if (wait_ms) wait_millis(wait_ms);
     }
 
+    // keeps the watchdog fed, but only as long as time passes
     void wait_millis(uint16_t ms) {
         uint32_t start = millis();
+        uint32_t fed = start;
         while ((millis() - start) < ms) {
             mp3.loop();
             delay(1);
+            if (millis() != fed) {
+                fed = millis();
+                wdt_reset();
+            }
         }
     }
 
@@ -92,6 +106,10 @@ void Enunciator::turnOff() {
     impl->turnOff();
 }
 
+void Enunciator::setVolume(uint8_t volume) {
+    impl->setVolume(volume);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void Enunciator::overture(Playback playback) {
@@ -112,6 +130,7 @@ void Enunciator::announce_adjustment_phase(Playback playback) {
 
 void Enunciator::laughout(Playback playback) {
     impl->play(MP3_LAUGHOUT, bool(playback) ? 3936 : 0);
+    TRACE(Laughed);
 }
 
 void Enunciator::halloween_song(Playback playback) {
@@ -18,6 +18,8 @@ public:
 
     void turnOff(void);
 
+    void setVolume(uint8_t volume);
+
     void overture(Playback playback = Playback::Nonblocking);
     void announce_waiting_time(Playback playback = Playback::Nonblocking);
     void announce_readiness(Playback playback = Playback::Nonblocking);
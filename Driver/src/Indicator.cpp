@@ -1,17 +1,64 @@
 #include "Indicator.h"
 
 #include <FastLED.h>
+#include <util/crc16.h>
 
-#include "millis.h"
+#include "Emitter.h"
+#include "Listener.h"
+#include "Timer.h"
+#include "Tracer.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define FPS 25
+// frames queued, at least the one rendered at the deadline without render-ahead
+#define DEPTH (INDICATOR_AHEAD > 0 ? INDICATOR_AHEAD : 1)
 
-enum mode_t {
+// current of an LED per channel at full brightness and when dark, in mA
+#define CHANNEL_CURRENT 20
+#define IDLE_CURRENT 1
+
+#define STREAM_SYNC 0xFE
+#define STREAM_TIMEOUT 500
+
+static_assert(!INDICATOR_SPI || (LEDS_PIN == 11 && TX0 != 11), "SPI drives the LEDs from pin 11");
+
+enum effect_t {
     off,
     fire,
-    disco
+    disco,
+    playback,
+    audio
+};
+
+enum stream_kind_t {
+    rgb,
+    indexed
+};
+
+// position of the receiver within a frame of the stream
+enum class Receiving : uint8_t {
+    Idle,
+    Kind,
+    Sequence,
+    Length,
+    Payload,
+    ChecksumLow,
+    ChecksumHigh
+};
+
+// operations of an animation, see tools/animate.py
+enum operation_t {
+    skip,
+    fill,
+    copy,
+    delta
+};
+
+// a frame rendered ahead with the sum of its channels
+struct slot_t {
+    CRGB *pixels;
+    uint32_t load;
 };
 
 struct flame_t {
@@ -34,12 +81,21 @@ const CRGBPalette16 HalloweenColorsPalette (
 
 CRGBPalette16 strobePalette(HalloweenColorsPalette);
 
+// hues of the bands of the audio: orange bass, green voices, purple hiss
+#define BASS_HUE 24
+#define VOICE_HUE 96
+#define HISS_HUE 192
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Indicator::Implementation {
 public:
-    Implementation(uint8_t pin, uint8_t count)
-        : pin(pin), count(count), leds(new CRGB[count]) {
+    Implementation(uint8_t pin, uint8_t count, uint16_t budget)
+        : pin(pin), count(count), budget(budget), leds(new CRGB[count]) {
+
+        for (uint8_t index = 0; index < DEPTH; index++) {
+            slots[index].pixels = new CRGB[count];
+        }
 
         flames_count = count / 3;
         flames = new flame_t[flames_count];
@@ -48,64 +104,232 @@ public:
     }
 
     ~Implementation() {
-        delete leds;
-        delete flames;
+        delete[] leds;
+        delete[] back;
+        for (uint8_t index = 0; index < DEPTH; index++) {
+            delete[] slots[index].pixels;
+        }
+        delete[] flames;
     }
 
     bool begin(uint8_t brightness) {
         this->brightness = brightness;
 
-        FastLED.addLeds<APA106, LEDS_PIN, GRB>(leds, count);
-        FastLED.clear(true);
+        #if INDICATOR_SPI
+        static Emitter emitter(count);
+        controller = &FastLED.addLeds(&emitter, leds, count);
+        #else
+        controller = &FastLED.addLeds<APA106, LEDS_PIN, GRB>(leds, count);
+        #endif
+        darken();
+        frame.repeat(1000 / FPS);
 
         return true;
     }
 
     bool loop() {
-        if (loop_ms > 1000 / FPS) {
-
-            switch (mode) {
-            case fire:
-                burn();
-                break;
-            case disco:
-                pulse();
-                break;
-            case off:
-                break;
+        if (mode == audio) {
+            Listener::update();
+        }
+        if (stream_timeout.hasExpired() && (streaming || receiving != Receiving::Idle)) {
+            fallBack();
+        }
+        if (fresh) {
+            fresh = false;
+            show(brightness);
+            return true;
+        }
+        if (streaming) {
+            return true;
+        }
+        if (frame.hasFired()) {
+            if (queued == 0) {
+                if (INDICATOR_AHEAD > 0 && mode != audio) {
+                    timing.starved++;
+                }
+                render();
             }
-            FastLED.show(mode_brightness);
-
-            loop_ms = 0;
+            present();
+            return true;
+        }
+        // between the deadlines, the audio follows the sound as it happens
+        if (INDICATOR_AHEAD > 0 && queued < DEPTH && mode != audio) {
+            render();
         }
         return true;
     }
 
     void lightUp(void) {
         light_fire();
-        mode = fire;
+        select(fire);
         mode_brightness = scale8(brightness, 100);
+        invalidate();
     }
 
     void danceIn(void) {
-        mode = disco;
+        select(disco);
         mode_brightness = brightness;
+        invalidate();
+    }
+
+    void play(const animation_t *animation) {
+        memcpy_P(&this->animation, animation, sizeof(animation_t));
+        cursor = this->animation.data;
+        played = 0;
+        select(playback);
+        mode_brightness = brightness;
+        invalidate();
+    }
+
+    void listen(void) {
+        select(audio);
+        mode_brightness = brightness;
+        invalidate();
+    }
+
+    void setBrightness(uint8_t brightness) {
+        this->brightness = brightness;
+        switch (mode) {
+        case fire:
+            mode_brightness = scale8(brightness, 100);
+            break;
+        case disco:
+        case playback:
+        case audio:
+            mode_brightness = brightness;
+            break;
+        case off:
+            break;
+        }
     }
 
     void turnOff(void) {
-        mode = off;
-        FastLED.clear(true);
+        select(off);
+        if (!streaming) {
+            darken();
+        }
+    }
+
+    // Receives straight into the back buffer, which becomes the shown buffer
+    // once the frame is complete and valid.
+    bool receive(uint8_t data) {
+        if (receiving == Receiving::Idle) {
+            if (data != STREAM_SYNC) {
+                return false;
+            }
+            if (!back) {
+                back = new CRGB[count];
+            }
+            checksum = 0xFFFF;
+            stream_timeout.start(STREAM_TIMEOUT);
+            receiving = Receiving::Kind;
+            return true;
+        }
+
+        switch (receiving) {
+        case Receiving::Kind:
+            stream_kind = data;
+            receiving = Receiving::Sequence;
+            break;
+        case Receiving::Sequence:
+            sequence = data;
+            receiving = Receiving::Length;
+            break;
+        case Receiving::Length:
+            length = data;
+            back_load = 0;
+            pixel = 0;
+            channel = 0;
+            receiving = length > 0 ? Receiving::Payload : Receiving::ChecksumLow;
+            break;
+        case Receiving::Payload:
+            if (pixel < count) {
+                back[pixel][channel] = data;
+                if (stream_kind == rgb) {
+                    back_load += data;
+                }
+            }
+            if (stream_kind == rgb && ++channel < 3) {
+                break;
+            }
+            channel = 0;
+            if (++pixel == length) {
+                receiving = Receiving::ChecksumLow;
+            }
+            break;
+        case Receiving::ChecksumLow:
+            received = data;
+            receiving = Receiving::ChecksumHigh;
+            return true;
+        case Receiving::ChecksumHigh:
+            received |= uint16_t(data) << 8;
+            receiving = Receiving::Idle;
+            complete(received == checksum);
+            return true;
+        case Receiving::Idle:
+            break;
+        }
+        checksum = _crc16_update(checksum, data);
+        return true;
+    }
+
+    bool isStreaming(void) {
+        return streaming;
+    }
+
+    stream_t stream(void) {
+        return statistics;
+    }
+
+    void clearStream(void) {
+        statistics.frames = 0;
+        statistics.dropped = 0;
+        statistics.span = 0;
+    }
+
+    power_t power(void) {
+        power_t power = { drawn, limited };
+        return power;
+    }
+
+    void clearPower(void) {
+        limited = 0;
+    }
+
+    timing_t frames(void) {
+        timing_t frames = { timing.frames, uint16_t(timing.frames ? deviations / timing.frames : 0),
+            timing.worst, timing.starved };
+        return frames;
+    }
+
+    void clearFrames(void) {
+        memset(&timing, 0, sizeof(timing));
+        deviations = 0;
     }
 
 private:
     uint8_t pin;
     uint8_t count;
+    uint16_t budget;
 
     CRGB *leds;
 
     uint8_t brightness = 20;
 
-    elapsed_millis loop_ms;
+    Timer frame;
+
+    // ring of frames rendered ahead, the effects paint into the canvas
+    slot_t slots[DEPTH];
+    uint8_t head = 0;
+    uint8_t queued = 0;
+    CRGB *canvas;
+    // ms of the effect for the frame rendered next
+    uint32_t time = 0;
+
+    timing_t timing = { 0, 0, 0, 0 };
+    uint32_t deviations = 0;
+    uint32_t presented_at;
+    bool presenting = false;
 
     uint8_t flames_count;
     flame_t *flames;
@@ -115,8 +339,37 @@ private:
     uint8_t strobeHue;
     int8_t strobePosition;
 
-    mode_t mode = off;
+    animation_t animation;
+    const uint8_t *cursor;
+    uint16_t played;
+
+    CLEDController *controller;
+    CRGB *back = nullptr;
+    uint32_t back_load;
+    Timer stream_timeout;
+    Receiving receiving = Receiving::Idle;
+    uint8_t stream_kind;
+    uint8_t sequence;
+    uint8_t expected;
+    uint8_t length;
+    uint8_t pixel;
+    uint8_t channel;
+    uint16_t checksum;
+    uint16_t received;
+    bool streaming = false;
+    bool fresh = false;
+    stream_t statistics = { 0, 0, 0 };
+    uint16_t first;
+
+    effect_t mode = off;
     uint8_t mode_brightness;
+
+    // sum of all channels of the canvas, kept up to date by paint(), and of
+    // the leds
+    uint32_t load = 0;
+    uint32_t shown_load = 0;
+    uint16_t drawn = 0;
+    uint16_t limited = 0;
  
     void light_flame(uint8_t index) {
         flames[index].heat = qadd8(flames[index].heat, random8(160, 255));
@@ -152,10 +405,271 @@ private:
             CRGB color;
             uint8_t number = index * 3;
             color = HeatColor(flames[index].heat);
-            leds[number + 1] = color;
+            paint(number + 1, color);
             color = HeatColor(flames[index].heat * 0.66);
-            leds[number + 0] = color;
-            leds[number + 2] = color;
+            paint(number + 0, color);
+            paint(number + 2, color);
+        }
+    }
+
+    static uint16_t weight(const CRGB& color) {
+        return uint16_t(color.r) + color.g + color.b;
+    }
+
+    // All effects write the canvas through here, so the load follows each
+    // pixel instead of a scan of the frame before every show.
+    void paint(uint8_t index, const CRGB& color) {
+        load += weight(color);
+        load -= weight(canvas[index]);
+        canvas[index] = color;
+    }
+
+    void clear(void) {
+        for (uint8_t index = 0; index < count; index++) {
+            canvas[index] = CRGB::Black;
+        }
+        load = 0;
+    }
+
+    void darken(void) {
+        invalidate();
+        canvas = leds;
+        clear();
+        shown_load = 0;
+        show(0);
+    }
+
+    // Switches the effect, the listener only samples for the audio.
+    void select(effect_t effect) {
+        if (effect == audio && mode != audio) {
+            Listener::begin(LISTENER_PIN);
+        }
+        else if (effect != audio && mode == audio) {
+            Listener::end();
+        }
+        mode = effect;
+    }
+
+    // Drops the frames rendered ahead, the next one continues from the leds.
+    void invalidate(void) {
+        queued = 0;
+        load = shown_load;
+        time = millis();
+    }
+
+    // Renders the next frame of the effect on top of the newest one into the
+    // ring, stamped with the time it is meant for.
+    void render(void) {
+        slot_t& slot = slots[(head + queued) % DEPTH];
+        const CRGB *newest = queued > 0 ? slots[(head + queued - 1) % DEPTH].pixels : leds;
+        memcpy(slot.pixels, newest, count * sizeof(CRGB));
+        canvas = slot.pixels;
+
+        switch (mode) {
+        case fire:
+            burn();
+            break;
+        case disco:
+            pulse();
+            break;
+        case playback:
+            advance();
+            break;
+        case audio:
+            hear();
+            break;
+        case off:
+            break;
+        }
+        slot.load = load;
+        time += 1000 / FPS;
+        queued++;
+    }
+
+    // At the deadline only the buffers are swapped and shown.
+    void present(void) {
+        slot_t& slot = slots[head];
+        CRGB *shown = leds;
+        leds = slot.pixels;
+        slot.pixels = shown;
+        controller->setLeds(leds, count);
+        shown_load = slot.load;
+        head = (head + 1) % DEPTH;
+        queued--;
+
+        show(mode_brightness);
+        if (mode == disco || mode == playback) {
+            TRACE(Shown);
+        }
+
+        uint32_t now = micros();
+        if (presenting) {
+            uint32_t interval = now - presented_at;
+            uint32_t period = 1000000UL / FPS;
+            uint32_t deviation = interval > period ? interval - period : period - interval;
+            deviations += deviation;
+            if (deviation > timing.worst) {
+                timing.worst = deviation > 0xFFFF ? 0xFFFF : deviation;
+            }
+            timing.frames++;
+        }
+        presented_at = now;
+        presenting = true;
+    }
+
+    // mA of the lit channels of the leds, scaled like scale8()
+    uint32_t current(uint8_t scale) {
+        return shown_load * CHANNEL_CURRENT * (scale + 1UL) / (255UL * 256);
+    }
+
+    // Lowers the brightness as far as the estimate exceeds the budget.
+    void show(uint8_t scale) {
+        uint16_t idle = uint16_t(count) * IDLE_CURRENT;
+        uint32_t lit = current(scale);
+        if (idle + lit > budget && shown_load > 0) {
+            uint32_t allowed = budget > idle ? budget - idle : 0;
+            uint32_t highest = allowed * (255UL * 256) / (shown_load * CHANNEL_CURRENT);
+            scale = highest > 0 ? highest - 1 : 0;
+            lit = current(scale);
+            limited++;
+        }
+        drawn = idle + lit;
+        FastLED.show(scale);
+    }
+
+    void complete(bool valid) {
+        if (!valid || stream_kind > indexed) {
+            // most likely the frame that was expected
+            statistics.dropped++;
+            expected++;
+            return;
+        }
+        if (streaming && sequence != expected) {
+            statistics.dropped += uint8_t(sequence - expected);
+        }
+        expected = sequence + 1;
+
+        for (uint8_t index = 0; index < count; index++) {
+            if (index >= length) {
+                back[index] = CRGB::Black;
+            }
+            else if (stream_kind == indexed) {
+                back[index] = ColorFromPalette(HalloweenColorsPalette, back[index].r);
+                back_load += weight(back[index]);
+            }
+        }
+        CRGB *shown = leds;
+        leds = back;
+        back = shown;
+        controller->setLeds(leds, count);
+        shown_load = back_load;
+        invalidate();
+        presenting = false;
+
+        uint16_t now = millis();
+        if (statistics.frames == 0) {
+            first = now;
+        }
+        statistics.frames++;
+        statistics.span = now - first;
+        streaming = true;
+        fresh = true;
+    }
+
+    // back to the effect, an animation restarts as its deltas need their frames
+    void fallBack(void) {
+        if (receiving != Receiving::Idle) {
+            statistics.dropped++;
+            receiving = Receiving::Idle;
+        }
+        if (!streaming) {
+            return;
+        }
+        streaming = false;
+        switch (mode) {
+        case playback:
+            cursor = animation.data;
+            played = 0;
+            break;
+        case off:
+            darken();
+            break;
+        case fire:
+        case disco:
+        case audio:
+            break;
+        }
+        // the effects resume a period from now, the gap since their last
+        // frame is no interval of theirs
+        frame.repeat(1000 / FPS);
+        presenting = false;
+    }
+
+    // Decodes the next frame of the animation right into the leds. Operations
+    // cover all leds of the animation, those beyond count are skipped.
+    void advance(void) {
+        if (played == animation.frames) {
+            cursor = animation.data;
+            played = 0;
+        }
+        played++;
+
+        uint8_t index = 0;
+        while (index < animation.leds) {
+            uint8_t operation = pgm_read_byte(cursor++);
+            uint8_t number = (operation & 0x3F) + 1;
+            switch (operation >> 6) {
+            case skip:
+                index += number;
+                break;
+            case fill: {
+                CRGB color(pgm_read_byte(cursor), pgm_read_byte(cursor + 1), pgm_read_byte(cursor + 2));
+                cursor += 3;
+                for (; number > 0; number--, index++) {
+                    if (index < count) paint(index, color);
+                }
+                break;
+            }
+            case copy:
+                for (; number > 0; number--, index++, cursor += 3) {
+                    if (index < count) {
+                        paint(index, CRGB(pgm_read_byte(cursor), pgm_read_byte(cursor + 1),
+                            pgm_read_byte(cursor + 2)));
+                    }
+                }
+                break;
+            case delta:
+                for (; number > 0; number--, index++, cursor += 2) {
+                    if (index < count) {
+                        // 5 bit signed per channel: 0rrrrrgggggbbbbb
+                        uint16_t packed = pgm_read_word(cursor);
+                        CRGB color = canvas[index];
+                        color.r += int8_t(uint8_t(packed >> 10) << 3) >> 3;
+                        color.g += int8_t(uint8_t(packed >> 5) << 3) >> 3;
+                        color.b += int8_t(uint8_t(packed) << 3) >> 3;
+                        paint(index, color);
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    // Lights all leds as loud as the audio, in the hues of its bands mixed by
+    // their magnitudes.
+    void hear(void) {
+        uint8_t bass = Listener::band(Listener::Bass);
+        uint8_t voice = Listener::band(Listener::Voice);
+        uint8_t hiss = Listener::band(Listener::Hiss);
+        uint16_t total = uint16_t(bass) + voice + hiss;
+        uint8_t hue = BASS_HUE;
+        if (total > 0) {
+            hue = (uint32_t(bass) * BASS_HUE + uint32_t(voice) * VOICE_HUE + uint32_t(hiss) * HISS_HUE) / total;
+        }
+        CRGB color;
+        hsv2rgb_rainbow(CHSV(hue, 255, Listener::level()), color);
+        for (uint8_t index = 0; index < count; index++) {
+            paint(index, color);
         }
     }
 
@@ -163,19 +677,22 @@ private:
         // Disco strobe effect taken from
         // https://gist.github.com/kriegsman/626dca2f9d2189bd82ca
 
-        FastLED.clear();
+        clear();
 
         strobe = (strobe + 1) % 4; if (strobe != 0) return;
 
-        uint8_t dashperiod = beatsin8(8, 4, 10);
+        // beats at the time of the frame rather than now
+        uint32_t timebase = millis() - time;
+
+        uint8_t dashperiod = beatsin8(8, 4, 10, timebase);
         uint8_t dashwidth = dashperiod / 4 + 1;
-        int8_t  dashspeed = beatsin8(30, 1, dashperiod);
+        int8_t  dashspeed = beatsin8(30, 1, dashperiod, timebase);
 
         if (dashspeed >= (dashperiod / 2)) {
             dashspeed = 0 - (dashperiod - dashspeed);
         }
 
-        uint8_t huedelta = scale8(cubicwave8(ease8InOutCubic(ease8InOutCubic(beat8(2)))), 130);
+        uint8_t huedelta = scale8(cubicwave8(ease8InOutCubic(ease8InOutCubic(beat8(2, timebase)))), 130);
 
         // work
 
@@ -207,7 +724,7 @@ private:
             CRGB color = ColorFromPalette(strobePalette, hue, 255, NOBLEND);
             uint8_t p = i;
             for (uint8_t w = 0; w < dashwidth && p < count; w++, p++) {
-                leds[p] = color;
+                paint(p, color);
             }
             hue += huedelta;
         }
@@ -217,8 +734,8 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-Indicator::Indicator(uint8_t pin, uint8_t count)
-    : impl(new Implementation(pin, count)) {
+Indicator::Indicator(uint8_t pin, uint8_t count, uint16_t budget)
+    : impl(new Implementation(pin, count, budget)) {
 }
 
 Indicator::~Indicator() {
@@ -243,8 +760,56 @@ void Indicator::danceIn() {
     impl->danceIn();
 }
 
+void Indicator::play(const animation_t *animation) {
+    impl->play(animation);
+}
+
+void Indicator::listen() {
+    impl->listen();
+}
+
 void Indicator::turnOff() {
     impl->turnOff();
 }
 
+void Indicator::setBrightness(uint8_t brightness) {
+    impl->setBrightness(brightness);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Indicator::receive(uint8_t data) {
+    return impl->receive(data);
+}
+
+bool Indicator::isStreaming() {
+    return impl->isStreaming();
+}
+
+Indicator::stream_t Indicator::stream() {
+    return impl->stream();
+}
+
+void Indicator::clearStream() {
+    impl->clearStream();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Indicator::power_t Indicator::power() {
+    return impl->power();
+}
+
+void Indicator::clearPower() {
+    impl->clearPower();
+}
+
+Indicator::timing_t Indicator::frames() {
+    return impl->frames();
+}
+
+void Indicator::clearFrames() {
+    impl->clearFrames();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
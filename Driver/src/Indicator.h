@@ -9,7 +9,41 @@ class Indicator {
     class Implementation;
 
 public:
-    Indicator(uint8_t pin, uint8_t count);
+    // An animation converted from an image strip by tools/animate.py, stored
+    // in PROGMEM like its data: frames of operations on the previous frame.
+    struct animation_t {
+        const uint8_t *data;
+        uint16_t frames;
+        uint8_t leds;
+    };
+
+    // frames received from the stream, frames lost or corrupted and ms from
+    // the first to the last frame received
+    struct stream_t {
+        uint16_t frames;
+        uint16_t dropped;
+        uint16_t span;
+    };
+
+    // estimated mA of the last frame shown, frames dimmed to stay within the
+    // budget
+    struct power_t {
+        uint16_t current;
+        uint16_t limited;
+    };
+
+    // frames shown by the effects, mean and largest deviation of the time
+    // between them from the frame period in us, and frames that weren't
+    // rendered ahead in time
+    struct timing_t {
+        uint16_t frames;
+        uint16_t jitter;
+        uint16_t worst;
+        uint16_t starved;
+    };
+
+    // budget: mA the LEDs may draw, brightness is lowered for frames beyond
+    Indicator(uint8_t pin, uint8_t count, uint16_t budget);
     ~Indicator();
 
     bool begin(uint8_t brightness);
@@ -17,8 +51,34 @@ public:
 
     void lightUp(void);
     void danceIn(void);
+    // Plays the animation from its first frame in a loop.
+    void play(const animation_t *animation);
+    // Follows the audio of the MP3 module on LISTENER_PIN, see Listener.
+    void listen(void);
     void turnOff(void);
 
+    void setBrightness(uint8_t brightness);
+
+    // Frames streamed from a host (tools/stream.py) replace the effects until
+    // the stream stalls for half a second. Frame: 0xFE, kind (0 RGB, 1 index
+    // into the Halloween palette), 8 bit sequence, number of LEDs, 3 or 1
+    // bytes per LED, CRC-16 (MODBUS, little endian) from kind to the last LED.
+    // Takes a byte of the serial, returns false if it is not part of a frame.
+    bool receive(uint8_t data);
+    bool isStreaming(void);
+    // since the last clearStream()
+    stream_t stream(void);
+    void clearStream(void);
+
+    // limited since the last clearPower()
+    power_t power(void);
+    void clearPower(void);
+
+    // Effects render up to INDICATOR_AHEAD frames ahead between the frame
+    // deadlines, state changes drop them. Since the last clearFrames().
+    timing_t frames(void);
+    void clearFrames(void);
+
 private:
     Indicator(const Indicator&);
     Indicator& operator=(const Indicator&);
@@ -26,6 +26,7 @@
 //  9. Adjusts the servo to release the Jack-In-The-Box activator.
 //     Plays a sound using the MP3 module to signal activator is triggered.
 //     Begins to visualize disco strobe using the LED module.
+//     (These actions are performed along a choreography timeline.)
 // 10. Stopps all sounds and lights after Jack finished. Starts again at step 1.
 //
 // Copyright (c) 2017 Michael Baumgärtner
@@ -50,6 +51,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <SoftwareSerial.h>
+#include <avr/wdt.h>
 
 #include "Jack.h"
 
@@ -58,14 +60,54 @@
 #include "Receptor.h"
 #include "Activator.h"
 #include "Indicator.h"
+#include "Listener.h"
+#include "Choreographer.h"
+#include "Scheduler.h"
+#include "Sleeper.h"
+#include "Profiler.h"
+#include "Tracer.h"
+#include "Logger.h"
+#include "Recorder.h"
+#include "Configurator.h"
+#include "Supervisor.h"
+#include "Timer.h"
+#include "Capturer.h"
+#include "Monitor.h"
+#include "Blackout.h"
+#include "Animations.h"
+#include "Bus.h"
+
+const configuration_t defaults PROGMEM = {
+    Configurator::Version,
+    ENUNCIATOR_VOLUME,
+    INDICATOR_BRIGHTNESS,
+    BUTTON_DEBOUNCE,
+    RECEPTOR_DEBOUNCE,
+    SERVO_RELEASED,
+    SERVO_REFRAINED,
+    MOUNTED_CLEAR_TIME,
+    TRIGGERED_PERFORM_TIME,
+    BUTTON_HOLD_TIME,
+    0
+};
+
+configuration_t configuration;
 
-#include "millis.h"
+Configurator configurator(configuration, &defaults, CONFIGURATOR_ADDRESS);
 
 SoftwareSerial Serial0(RX0, TX0);
 
+Logger logger(Serial, 96);
+
+#if BUS_ADDRESS
+static_assert(!DEBUG, "the bus takes over the serial of the debug log");
+static_assert(SLEEPER_MODE < 2, "the bus has to be heard while equipped");
+Bus bus(Serial, BUS_ENABLE_PIN, BUS_ADDRESS, BUS_BAUD, BUS_CASCADE);
+#endif
+
 Enunciator enunciator(Serial0);
 
-Indicator indicator(LEDS_PIN, LEDS_COUNT);
+Indicator indicator(LEDS_PIN, LEDS_COUNT, LEDS_BUDGET);
 
 Activator activator(SERVO_PIN, SERVO_RELEASED, SERVO_REFRAINED);
 
@@ -73,35 +115,148 @@ Receptor receptor(SENSOR_PIN, Receptor::PullUp::Enable, RECEPTOR_DEBOUNCE);
 
 Button button(BUTTON_PIN, Button::PullUp::Enable, BUTTON_DEBOUNCE);
 
+Activator *activators[] = { &activator };
+
+Choreographer choreographer(activators, sizeof(activators) / sizeof(activators[0]), enunciator, indicator);
+
+// choreography of a scare, performed when Jack is triggered
+const Choreographer::cue_t scare[] PROGMEM = {
+    {    0, Choreographer::Action::Release, 0, 0 },
+    {    0, Choreographer::Action::Laughout, 0, 0 },
+    {    0, Choreographer::Action::Play, 0, lightning_animation },
+    { 1200, Choreographer::Action::DanceIn, 0, 0 },
+    {    0, Choreographer::Action::End, 0, 0 }
+};
+
+Scheduler scheduler(10);
+
+Sleeper sleeper(SENSOR_PIN, BUTTON_PIN);
+
+Recorder recorder(RECORDER_ADDRESS, RECORDER_SLOTS, RECORDER_INTERVAL);
+
+Supervisor supervisor(SUPERVISOR_TIMEOUT);
+
+// profiled and supervised modules
+enum module_t : uint8_t {
+    button_module,
+    receptor_module,
+    states_module,
+    activator_module,
+    choreographer_module,
+    indicator_module,
+    enunciator_module,
+    sleeper_module,
+    recorder_module,
+    logger_module,
+    bus_module,
+
+    modules_count
+};
+
+// marks the module as active for the supervisor and profiles the statement
+#define RUN(number, statement) \
+    { supervisor.enter(number); PROFILE(number, statement); }
+
+#if PROFILER
+Profiler profiler(modules_count);
+#endif
+
+void sense(void);
+void act(void);
+void illuminate(void);
+void enunciate(void);
+void report(void);
+void command(void);
+void drain(void);
+void network(void);
+void persist(void);
+void monitor(void);
+void configure(void);
+void history(void);
+
 #undef WARMUP
 
 void warmup() {
     // Warmup Jack-In-The-Box:
-    DSERIAL.println(F("Jack Warmup ..."));
+    DLOG.log(Message::Warmup);
     enunciator.overture(Enunciator::Playback::Blocking);
 }
 
 void setup() {
-    DSERIAL_BEGIN;
+    Monitor::paint();
+
+    bool recovered = supervisor.begin();
+
+    DLOG_BEGIN;
 
     // Setup Jack-In-The-Box:
-    DSERIAL.println(F("Jack Setup ..."));
+    DLOG.log(Message::Setup);
+    if (recovered) {
+        DLOG.log(Message::Failed, uint8_t(supervisor.reason()), supervisor.state(), supervisor.module(),
+            supervisor.recoveries());
+    }
+
+    if (!configurator.begin()) {
+        DLOG.log(Message::Defaulted);
+    }
 
-    enunciator.begin(ENUNCIATOR_VOLUME);
-    indicator.begin(INDICATOR_BRIGHTNESS);
+    enunciator.begin(configuration.volume);
+    indicator.begin(configuration.brightness);
+    receptor.setReader(Capturer::read);
+    button.setReader(Capturer::read);
     receptor.begin();
     activator.begin();
     button.begin();
+    choreographer.begin();
+    sleeper.begin();
+    recorder.begin();
+    if (recovered) {
+        recorder.countCrash();
+    }
+    configure();
+    #if PROFILER
+    profiler.begin();
+    #endif
+    #if BLACKOUT
+    Blackout::begin();
+    #endif
+    #if BUS_ADDRESS
+    Serial.begin(BUS_BAUD);
+    bus.begin();
+    #endif
+
+    // tasks: period and deadline in milliseconds, priority
+    scheduler.add(sense, 2, 2, 4);
+    scheduler.add(act, 1, 2, 3);
+    scheduler.add(illuminate, 4, 10, 2);
+    scheduler.add(enunciate, 10, 20, 1);
+    scheduler.add(persist, 20, 100, 0);
+    scheduler.add(monitor, 100, 100, 0);
+    if (DEBUG) {
+        scheduler.add(report, 10000, 1000, 0);
+        scheduler.add(command, 20, 20, 0);
+        scheduler.add(drain, 5, 50, 0);
+    }
+    if (BUS_ADDRESS) {
+        // a byte takes 260us at 38400 baud, the serial buffers 64
+        scheduler.add(network, 1, 5, 1);
+    }
+    scheduler.begin();
 
     #ifdef WARMUP
-    warmup();
+    // after a failure Jack goes straight back to work
+    if (!recovered) {
+        warmup();
+    }
     #endif
 
-    DSERIAL.println(F("Jack In-The-Box running ..."));
+    history();
+
+    DLOG.log(Message::Running);
 }
 
 // states
-enum state_t {
+enum state_t : uint8_t {
     installed,
 
     // Jack is prepared to be mounted
@@ -121,166 +276,722 @@ enum state_t {
     crashed,
 
     // intermediate states
-    button_pressed,
-    button_released
+
+    // Jack is equipped, but the button is still held
+    equipped_held,
+
+    states_count
 };
 
 // active state
 state_t state = installed;
-// elapsed time since the state became active
-elapsed_millis state_time;
+// time the active state was last accounted for in the records
+uint32_t state_accounted;
+// started with the timeout of the state when it became active
+Timer state_timeout;
 
-state_t button_next_state;
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// guards
 
-void transition(state_t to);
-void transition_with_button_pressed(state_t to);
+bool always() {
+    return true;
+}
 
-void loop() {
-    button.read();
+bool button_was_released() {
+    return button.wasReleased();
+}
 
-    enunciator.loop();
-    indicator.loop();
-    receptor.loop();
-    activator.loop();
-
-    // handle states (not transitions)
-    switch (state) {
-    case installed: {
-        // ready to go
-        transition(prepared);
-        break;
-    }
-    case prepared: {
-        if (button.wasReleased()) {
-            transition(mounted);
-        }
-        break;
+bool button_is_released() {
+    return button.isReleased();
+}
+
+bool button_is_held() {
+    return button.pressedFor(configuration.hold_time);
+}
+
+bool motion_cleared() {
+    return state_timeout.hasExpired() && receptor.isClear();
+}
+
+bool motion_sensed() {
+    return receptor.sensedMotion() || button.wasPressed();
+}
+
+// another Jack on the bus was triggered and the cascade reached this one
+bool cascaded() {
+    #if BUS_ADDRESS
+    return bus.isDue();
+    #else
+    return false;
+    #endif
+}
+
+bool performance_over() {
+    return state_timeout.hasExpired() || button.wasPressed();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// actions
+
+void prepare() {
+    activator.release();
+    enunciator.announce_adjustment_phase();
+
+    if (supervisor.recover()) {
+        DLOG.log(Message::Recovered, supervisor.recoveryTime());
     }
-    case mounted: {
-        if (state_time > 5000 && receptor.isClear()) {
-            transition(equipped);
-        }
-        if (button.wasReleased()) {
-            transition(prepared);
+}
+
+void mount() {
+    activator.restrain();
+    enunciator.announce_waiting_time();
+}
+
+void equip() {
+    if (SLEEPER_MODE < 2) {
+        enunciator.halloween_song();
+        if (INDICATOR_LISTEN) {
+            indicator.listen();
         }
-        if (button.pressedFor(3000)) {
-            transition_with_button_pressed(equipped);
+        else {
+            indicator.lightUp();
         }
-        break;
     }
-    case equipped: {
-        if (receptor.sensedMotion() || button.wasPressed()) {
-            transition(triggered);
-        }
-        break;
+}
+
+void rest() {
+    // powers down until motion or the button wakes Jack up
+    if (SLEEPER_MODE < 2 || receptor.isTriggered() || button.isPressed()) {
+        return;
     }
-    case triggered: {
-        if (state_time > 10000 || button.wasPressed()) {
-            transition(stopped);
-        }
-        break;
+    DLOG.flush();
+    supervisor.enter(sleeper_module);
+    supervisor.suspend();
+    sleeper.powerDown();
+    supervisor.resume();
+
+    button.read();
+    receptor.loop();
+}
+
+void trigger() {
+    #if TRACER
+    if (receptor.sensedMotion()) {
+        TRACE(Triggered);
     }
-    case stopped: {
-        if (button.isReleased()) {
-            transition(prepared);
-        }
-        break;
+    else {
+        Tracer::abandon();
+    }
+    #endif
+
+    choreographer.perform(scare);
+    // the first cues are due right away
+    choreographer.loop();
+
+    sleeper.measure();
+
+    recorder.countTrigger();
+}
+
+// tells the other Jacks on the bus
+void broadcast() {
+    #if BUS_ADDRESS
+    bus.trigger();
+    #endif
+}
+
+void stop() {
+    choreographer.stop();
+    indicator.turnOff();
+}
+
+// Jack is crashed, flash built-in led until the watchdog resets Jack
+void blink() {
+    static uint8_t count = 0;
+    digitalWrite(LED_BUILTIN, (count == 0) ? HIGH : LOW);
+    count = (count + 1) % 10;
+}
+
+Timer blinker(blink);
+
+void crash() {
+    DLOG.log(Message::Crashed);
+    enunciator.turnOff();
+    indicator.turnOff();
+    blinker.repeat(100);
+    // the crash is counted after the reset
+    supervisor.fail(Supervisor::Reason::Crash);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// transition table
+//
+// Rows are grouped by source state and checked in order, the first row
+// whose guard holds is taken. A transition runs the exit action of the
+// source state, the action of the row and the enter action of the target.
+
+typedef bool (*guard_t)(void);
+typedef void (*action_t)(void);
+
+struct transition_t {
+    state_t from;
+    state_t to;
+    guard_t guard;
+    action_t action;
+};
+
+constexpr transition_t transitions[] PROGMEM = {
+    { installed,     prepared,      always,               nullptr },
+    { prepared,      mounted,       button_was_released,  nullptr },
+    { mounted,       equipped,      motion_cleared,       equip   },
+    { mounted,       prepared,      button_was_released,  nullptr },
+    { mounted,       equipped_held, button_is_held,       equip   },
+    { equipped,      triggered,     motion_sensed,        broadcast },
+    { equipped,      triggered,     cascaded,             nullptr },
+    { triggered,     stopped,       performance_over,     nullptr },
+    { stopped,       prepared,      button_is_released,   nullptr },
+    { equipped_held, equipped,      button_was_released,  nullptr },
+};
+
+constexpr uint8_t transitions_count = sizeof(transitions) / sizeof(transitions[0]);
+
+constexpr uint8_t transitions_first(state_t s, uint8_t i = 0) {
+    return (i == transitions_count || transitions[i].from == s) ? i : transitions_first(s, i + 1);
+}
+
+constexpr uint8_t transitions_last(state_t s, uint8_t i) {
+    return (i == transitions_count || transitions[i].from != s) ? i : transitions_last(s, i + 1);
+}
+
+constexpr bool transitions_grouped(uint8_t i = 1) {
+    return i >= transitions_count ||
+        (transitions[i - 1].from <= transitions[i].from && transitions_grouped(i + 1));
+}
+
+constexpr bool transitions_valid(uint8_t i = 0) {
+    return i == transitions_count ||
+        (transitions[i].from < states_count && transitions[i].to < states_count &&
+         transitions[i].to != installed && transitions[i].guard != nullptr &&
+         transitions_valid(i + 1));
+}
+
+static_assert(transitions_grouped(), "transitions must be grouped by source state");
+static_assert(transitions_valid(), "transitions must connect known states and have a guard");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// state table
+//
+// Rows are in the order of state_t and hold the enter, during and exit
+// actions of each state, its timeout (a setting of the configuration) and
+// its slice of the transition table.
+
+struct activity_t {
+    state_t state;
+    uint8_t first;
+    uint8_t count;
+    action_t enter;
+    action_t during;
+    action_t exit;
+    const uint16_t *timeout;
+};
+
+constexpr activity_t activity(state_t s, action_t enter, action_t during, action_t exit,
+    const uint16_t *timeout = nullptr) {
+    return { s, transitions_first(s), uint8_t(transitions_last(s, transitions_first(s)) - transitions_first(s)),
+        enter, during, exit, timeout };
+}
+
+constexpr activity_t activities[] PROGMEM = {
+    activity(installed,     nullptr, nullptr, nullptr),
+    activity(prepared,      prepare, nullptr, nullptr),
+    activity(mounted,       mount,   nullptr, nullptr, &configuration.clear_time),
+    activity(equipped,      nullptr, rest,    nullptr),
+    activity(triggered,     trigger, nullptr, stop,    &configuration.perform_time),
+    activity(stopped,       nullptr, nullptr, nullptr),
+    activity(crashed,       crash,   nullptr, nullptr),
+    activity(equipped_held, nullptr, nullptr, nullptr),
+};
+
+constexpr bool activities_ordered(uint8_t i = 0) {
+    return i == states_count || (activities[i].state == i && activities_ordered(i + 1));
+}
+
+constexpr bool activities_escapable(uint8_t i = 0) {
+    return i == states_count ||
+        ((activities[i].count > 0 || activities[i].state == crashed) && activities_escapable(i + 1));
+}
+
+static_assert(sizeof(activities) / sizeof(activities[0]) == states_count, "every state needs an activity");
+static_assert(activities_ordered(), "activities must be in the order of the states");
+static_assert(activities_escapable(), "every state but crashed needs a transition");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// consumption table
+//
+// Estimated current draw per state in mA, awake and while sleeping in the
+// configured sleeper mode. Figures are for a 5V pro mini (15 mA active, 6 mA
+// idle, 3 mA powered down mostly through the power led), the mp3 module
+// (60 mA playing, 20 mA standing by), 12 leds (1 mA each when dark, about
+// 25 mA for the fire and 40 mA for the disco strobe) and the servo (10 mA).
+
+struct consumption_t {
+    uint8_t awake;
+    uint8_t asleep;
+};
+
+constexpr uint8_t consumption_asleep(uint8_t awake, uint8_t down) {
+    return SLEEPER_MODE == 0 ? awake : SLEEPER_MODE == 1 ? awake - 9 : down;
+}
+
+constexpr consumption_t consumptions[] PROGMEM = {
+    { 57,  consumption_asleep(57, 57) },   // installed
+    { 117, consumption_asleep(117, 117) }, // prepared
+    { 117, consumption_asleep(117, 117) }, // mounted
+    { 122, consumption_asleep(122, 45) },  // equipped
+    { 137, consumption_asleep(137, 137) }, // triggered
+    { 57,  consumption_asleep(57, 57) },   // stopped
+    { 57,  consumption_asleep(57, 57) },   // crashed
+    { 122, consumption_asleep(122, 122) }, // equipped_held
+};
+
+static_assert(sizeof(consumptions) / sizeof(consumptions[0]) == states_count, "every state needs a consumption");
+
+static_assert(uint8_t(states_count) <= uint8_t(Recorder::States), "recorder keeps too few states");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void transition(uint8_t index);
+void transition(state_t to, action_t action);
+
+void loop() {
+    supervisor.feed();
+
+    Timer::tick();
+
+    scheduler.loop();
+
+    if (SLEEPER_MODE > 0 && scheduler.isIdle()) {
+        supervisor.enter(sleeper_module);
+        sleeper.idle();
     }
-    case crashed: {
-        // Jack is crashed, flash built-in led forever
-        unsigned long ms = millis();
-        digitalWrite(LED_BUILTIN, ((ms % 1000 < 100) ? HIGH : LOW));
-        break;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// tasks
+
+void handle(void);
+
+// samples inputs and handles states
+void sense() {
+    RUN(button_module, button.read());
+    RUN(receptor_module, receptor.loop());
+
+    #if TRACER
+    // an edge happened at the earliest right after the previous sample
+    static uint32_t sampled = micros();
+    if (receptor.sensedMotion()) {
+        Tracer::begin(sampled);
     }
-    case button_pressed: {
-        if (button.wasReleased()) {
-            transition(button_next_state);
-        }
-        break;
+    sampled = micros();
+    #endif
+
+    RUN(states_module, handle());
+}
+
+// handle states (not transitions)
+void handle() {
+    if (state >= states_count) {
+        transition(crashed, nullptr);
+        return;
     }
-    case button_released: {
-        if (button.wasPressed()) {
-            transition(button_next_state);
+
+    const activity_t *activity = &activities[state];
+
+    action_t during = (action_t)pgm_read_ptr(&activity->during);
+    if (during) {
+        during();
+    }
+
+    uint8_t first = pgm_read_byte(&activity->first);
+    uint8_t last = first + pgm_read_byte(&activity->count);
+    for (uint8_t index = first; index < last; index++) {
+        guard_t guard = (guard_t)pgm_read_ptr(&transitions[index].guard);
+        if (guard()) {
+            transition(index);
+            break;
         }
-        break;
     }
-    default:
-        transition(crashed);
-        break;
+}
+
+void act() {
+    RUN(activator_module, activator.loop());
+    RUN(choreographer_module, choreographer.loop());
+}
+
+void illuminate() {
+    RUN(indicator_module, indicator.loop());
+}
+
+void enunciate() {
+    RUN(enunciator_module, enunciator.loop());
+}
+
+void proceed(void);
+
+void drain() {
+    RUN(logger_module, { logger.loop(); proceed(); });
+}
+
+void network() {
+    #if BUS_ADDRESS
+    RUN(bus_module, bus.loop());
+    #endif
+}
+
+// accounts the time of the active state and writes records, but never
+// while Jack performs
+void persist() {
+    supervisor.enter(recorder_module);
+
+    uint32_t ms = millis();
+    recorder.spend(state, ms - state_accounted);
+    state_accounted = ms;
+
+    recorder.setDeferred(state == triggered);
+    recorder.loop();
+}
+
+// warns once the stack came close to the heap
+void monitor() {
+    static bool warned = false;
+    uint16_t lowest = Monitor::check();
+    if (lowest < MONITOR_STACK_RESERVE && !warned) {
+        DLOG.log(Message::StackLow, lowest);
+        warned = true;
+    }
+}
+
+void history() {
+    const Recorder::record_t& record = recorder.record();
+    logger.setBlocking(true);
+    DLOG.log(Message::Recorded, record.triggers, record.crashes, recorder.lifetime());
+    for (uint8_t number = 0; number < states_count && number < Recorder::States; number++) {
+        DLOG.log(Message::RecordedState, record.seconds[number], number);
+    }
+    for (uint8_t number = 0; number < Recorder::History && number < record.triggers; number++) {
+        DLOG.log(Message::RecordedFired, record.history[number]);
     }
+    logger.setBlocking(false);
 }
 
-// handle transitions (not states)
-void transition(state_t to) {
-    DSERIAL.print(F("Jack goes from "));
-    DSERIAL.print(state);
-    DSERIAL.print(" to ");
-    DSERIAL.println(to);
-
-    switch (state) {
-    case prepared:
-        switch (to) {
-        case mounted:
-            activator.restrain();
-            enunciator.announce_waiting_time();
+// the report is larger than the buffer of the logger, so it waits for it
+// Items of the periodic report. The report goes out an item at a time while
+// the log has room for its largest record (Memory, 16 bytes) and for the
+// messages of the driver until the next drain(), which continues it. So it
+// never waits for the serial.
+enum report_item_t : uint8_t {
+    report_idle,
+    report_tasks,
+    report_sleep,
+    report_sleep_slow,
+    report_consumption,
+    report_memory,
+    report_power,
+    report_frames,
+    report_stream,
+    report_listener,
+    report_blackout,
+    report_dropped,
+    reported
+};
+
+#define REPORT_ROOM (16 + 32)
+
+report_item_t report_item = reported;
+uint8_t report_task;
+
+void report() {
+    supervisor.enter(logger_module);
+    report_item = report_idle;
+    report_task = 0;
+    proceed();
+}
+
+// logs the next items of the report, statistics are cleared as they are logged
+void proceed() {
+    while (report_item != reported && logger.room() >= REPORT_ROOM) {
+        switch (report_item) {
+        case report_idle:
+            DLOG.log(Message::Idle, scheduler.idle());
             break;
-        default: to = crashed; break;
-        }
-        break;
-    case mounted:
-        switch (to) {
-        case equipped:
-            enunciator.halloween_song();
-            indicator.lightUp();
+        case report_tasks:
+            if (report_task < scheduler.count()) {
+                Scheduler::statistics_t statistics = scheduler.statistics(report_task);
+                DLOG.log(Message::Task, report_task, statistics.runs, statistics.overruns, statistics.longest);
+                report_task++;
+                continue;
+            }
+            scheduler.clear();
+            break;
+        case report_sleep:
+            if (SLEEPER_MODE > 0) {
+                DLOG.log(Message::Sleep, sleeper.sleeps(), sleeper.latency(), sleeper.longestLatency(),
+                    uint16_t(SLEEPER_LATENCY_BUDGET));
+            }
             break;
-        case prepared:
-            activator.release();
+        case report_sleep_slow:
+            if (SLEEPER_MODE > 0 && sleeper.longestLatency() > SLEEPER_LATENCY_BUDGET) {
+                DLOG.log(Message::SleepSlow);
+            }
             break;
-        case button_pressed:
+        case report_consumption:
+            if (state < states_count) {
+                consumption_t consumption;
+                memcpy_P(&consumption, &consumptions[state], sizeof(consumption));
+                DLOG.log(Message::Consumption, consumption.awake, consumption.asleep);
+            }
+            break;
+        case report_memory: {
+            Monitor::memory_t memory = Monitor::memory();
+            DLOG.log(Message::Memory, memory.free, memory.lowest, memory.heap, memory.blocks, memory.released,
+                memory.largest);
+            break;
+        }
+        case report_power: {
+            Indicator::power_t power = indicator.power();
+            DLOG.log(Message::Power, power.current, uint16_t(LEDS_BUDGET), power.limited);
+            indicator.clearPower();
             break;
-        default: to = crashed; break;
         }
-        break;
-    case equipped:
-        switch (to) {
-        case triggered:
-            activator.release();
-            enunciator.laughout();
-            indicator.danceIn();
+        case report_frames: {
+            Indicator::timing_t frames = indicator.frames();
+            DLOG.log(Message::Frames, frames.frames, frames.jitter, frames.worst, frames.starved);
+            indicator.clearFrames();
             break;
-        default: to = crashed; break;
         }
-        break;
-    case triggered:
-        switch (to) {
-        case stopped:
-            indicator.turnOff();
+        case report_stream: {
+            Indicator::stream_t stream = indicator.stream();
+            if (stream.frames > 0 || stream.dropped > 0) {
+                uint8_t fps = stream.span ? (stream.frames - 1) * 1000UL / stream.span : 0;
+                DLOG.log(Message::Streamed, stream.frames, fps, stream.dropped);
+            }
+            indicator.clearStream();
             break;
-        default: to = crashed; break;
         }
-        break;
-    default: break;
-    }
-    switch (to) {
-    case prepared:
-        activator.release();
-        enunciator.announce_adjustment_phase();
-        break;
-    case crashed:
-        DSERIAL.println(F("Jack crashed ..."));
-        enunciator.turnOff();
-        indicator.turnOff();
-        break;
-    default: break;
+        case report_listener:
+            if (Listener::isListening()) {
+                DLOG.log(Message::Listened, Listener::spent(), Listener::processed(), Listener::overruns());
+                Listener::clear();
+            }
+            break;
+        case report_blackout:
+            #if BLACKOUT
+            DLOG.log(Message::Blackout, Blackout::longest());
+            Blackout::clear();
+            #endif
+            break;
+        case report_dropped:
+            if (logger.dropped() > 0) {
+                DLOG.log(Message::Dropped, logger.dropped());
+            }
+            break;
+        case reported:
+            break;
+        }
+        report_item = report_item_t(report_item + 1);
     }
-    state = to;
-    state_time = 0;
 }
-void transition_with_button_pressed(state_t to) {
-    transition(to);
 
-    button_next_state = to;
+void profile() {
+    #if PROFILER
+    DLOG.log(Message::ProfilerCost, profiler.overhead());
+    for (uint8_t number = 0; number < modules_count; number++) {
+        const Profiler::profile_t& profile = profiler.profile(number);
+        DLOG.log(Message::Profile, number, profile.count, profile.minimum,
+            uint16_t(profile.count ? profile.total / profile.count : 0), profile.maximum);
+        for (uint8_t bin = 0; bin < Profiler::Bins - 1; bin++) {
+            if (profile.bin(bin) != 0) {
+                DLOG.log(Message::ProfileBin, uint16_t(Profiler::FirstBin << bin), profile.bin(bin));
+            }
+        }
+        if (profile.bin(Profiler::Bins - 1) != 0) {
+            DLOG.log(Message::ProfileRest, profile.bin(Profiler::Bins - 1));
+        }
+    }
+    profiler.clear();
+    #endif
+}
+
+void trace() {
+    #if TRACER
+    DLOG.log(Message::Traced, Tracer::count());
+    for (uint8_t stage = 0; stage < Tracer::Stages; stage++) {
+        Tracer::percentiles_t percentiles = Tracer::percentiles(Tracer::Stage(stage));
+        DLOG.log(Message::Trace, stage, percentiles.median, percentiles.p90, percentiles.maximum);
+    }
+    #endif
+}
 
-    state = button_pressed;
-    state_time = 0;
+// streams the edges of the inputs, waiting for the serial: the deltas add
+// up to the timestamps, so a dropped edge would shift all later ones
+void edge(const Capturer::edge_t& edge) {
+    bool blocking = logger.isBlocking();
+    logger.setBlocking(true);
+    DLOG.log(Message::Edge, edge.pin, edge.level, edge.delta);
+    logger.setBlocking(blocking);
+}
+
+// applies the configuration to the modules
+void configure() {
+    enunciator.setVolume(configuration.volume);
+    indicator.setBrightness(configuration.brightness);
+    button.setDebounceTime(configuration.button_debounce);
+    receptor.setDebounceTime(configuration.receptor_debounce);
+    activator.setAngles(configuration.servo_released, configuration.servo_restrained);
+}
+
+void show(Configurator::Field field) {
+    DLOG.log(Message::Configured, uint8_t(field), configurator.get(field));
+}
+
+// executes a command line:
+//  p, t, h                 dump profile, traces or history
+//  c                       start or stop capturing the inputs
+//  list, get <field>       show configuration
+//  set <field> <value>     change configuration, effective at once
+//  save, defaults          store or reset configuration
+void execute(char *line) {
+    char *word = strtok(line, " ");
+    if (word == 0) {
+        return;
+    }
+    logger.setBlocking(true);
+    if (strcmp_P(word, PSTR("p")) == 0) {
+        profile();
+    }
+    else if (strcmp_P(word, PSTR("t")) == 0) {
+        trace();
+    }
+    else if (strcmp_P(word, PSTR("h")) == 0) {
+        history();
+    }
+    else if (strcmp_P(word, PSTR("c")) == 0) {
+        Capturer::capture(Capturer::isCapturing() ? nullptr : edge);
+        DLOG.log(Message::Capturing, uint8_t(Capturer::isCapturing()));
+    }
+    else if (strcmp_P(word, PSTR("list")) == 0) {
+        for (uint8_t field = 0; field < Configurator::Fields; field++) {
+            show(Configurator::Field(field));
+        }
+    }
+    else if (strcmp_P(word, PSTR("get")) == 0 || strcmp_P(word, PSTR("set")) == 0) {
+        bool setting = (word[0] == 's');
+        char *name = strtok(0, " ");
+        char *value = strtok(0, " ");
+        Configurator::Field field = configurator.find(name ? name : "");
+        if (field == Configurator::Fields || (setting && value == 0)) {
+            DLOG.log(Message::Unknown);
+        }
+        else if (setting) {
+            // digits only, range checked before narrowing to the field
+            char *end;
+            unsigned long number = strtoul(value, &end, 10);
+            if (!isdigit(value[0]) || *end != '\0') {
+                DLOG.log(Message::NotNumber);
+            }
+            else if (number > 0xFFFF || !configurator.set(field, uint16_t(number))) {
+                DLOG.log(Message::Rejected, uint8_t(field), uint16_t(number > 0xFFFF ? 0xFFFF : number));
+            }
+            else {
+                configure();
+                show(field);
+            }
+        }
+        else {
+            show(field);
+        }
+    }
+    else if (strcmp_P(word, PSTR("save")) == 0) {
+        configurator.save();
+        DLOG.log(Message::Saved);
+    }
+    else if (strcmp_P(word, PSTR("defaults")) == 0) {
+        configurator.reset();
+        configure();
+        DLOG.log(Message::Defaulted);
+    }
+    else {
+        DLOG.log(Message::Unknown);
+    }
+    logger.setBlocking(false);
+}
+
+// collects command lines from the debug serial and passes streamed frames on
+// to the indicator, often enough for the receive buffer of the serial (64
+// bytes) at 9600 baud
+void command() {
+    static char line[32];
+    static uint8_t length = 0;
+
+    supervisor.enter(logger_module);
+
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+        if (indicator.receive(uint8_t(c))) {
+            continue;
+        }
+        if (c == '\r') {
+            continue;
+        }
+        if (c != '\n') {
+            if (length < sizeof(line) - 1) {
+                line[length++] = c;
+            }
+            continue;
+        }
+        line[length] = 0;
+        length = 0;
+        execute(line);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// handle transitions (not states)
+void transition(uint8_t index) {
+    transition(state_t(pgm_read_byte(&transitions[index].to)),
+        (action_t)pgm_read_ptr(&transitions[index].action));
+}
+
+void transition(state_t to, action_t action) {
+    DLOG.log(Message::Transition, uint8_t(state), uint8_t(to));
+
+    if (state < states_count) {
+        action_t exit = (action_t)pgm_read_ptr(&activities[state].exit);
+        if (exit) {
+            exit();
+        }
+    }
+    if (action) {
+        action();
+    }
+    action_t enter = (action_t)pgm_read_ptr(&activities[to].enter);
+    if (enter) {
+        enter();
+    }
+
+    uint32_t ms = millis();
+    recorder.spend(state, ms - state_accounted);
+    state_accounted = ms;
+
+    const uint16_t *timeout = (const uint16_t *)pgm_read_ptr(&activities[to].timeout);
+    if (timeout) {
+        state_timeout.start(*timeout);
+    }
+    else {
+        state_timeout.stop();
+    }
+
+    state = to;
+    supervisor.track(state);
 }
@@ -9,11 +9,72 @@
 #define SERVO_REFRAINED 55
 #define LEDS_PIN 8
 #define LEDS_COUNT 12
+// mA the LEDs may draw from the supply shared with servo and Arduino, frames
+// estimated above are dimmed
+#define LEDS_BUDGET 300
+// LED output: false bit-bangs with FastLED, interrupts stay off for a whole
+// frame, true streams from the hardware SPI with interrupts on, which needs the
+// LEDs on MOSI (LEDS_PIN 11) and TX0 moved off it (e.g. to pin 10), the
+// built-in LED flickers with the clock while a frame goes out
+#define INDICATOR_SPI false
+// frames the effects render ahead into a ring between the frame deadlines, so
+// only a swap and a show remain at the deadline (3 * LEDS_COUNT bytes each); 0
+// renders at the deadline. Simulated with --costs and the log at 9600 baud,
+// the fire on 60 LEDs comes 88us off the period on average against 133us
+// without, the worst frames (up to 12ms late) wait for commands to the MP3
+// module either way
+#define INDICATOR_AHEAD 2
+// LEDs follow the audio from the DAC output of the MP3 module on an analog pin
+// instead of the fire while Jack is equipped
+#define INDICATOR_LISTEN false
+#define LISTENER_PIN A0
 
 #define ENUNCIATOR_VOLUME 30
 #define INDICATOR_BRIGHTNESS 50
 #define RECEPTOR_DEBOUNCE 25
 
+#define MOUNTED_CLEAR_TIME 5000
+#define TRIGGERED_PERFORM_TIME 10000
+#define BUTTON_HOLD_TIME 3000
+
+// settings above are defaults of the configuration stored in EEPROM
+#define CONFIGURATOR_ADDRESS 0
+
+// power saving: 0 never sleeps, 1 sleeps between tasks,
+// 2 also powers down while equipped (no lights and sound until triggered)
+#define SLEEPER_MODE 1
+// budget from waking up by motion to the release of the activator in us
+#define SLEEPER_LATENCY_BUDGET 5000
+
+// event counters in EEPROM, committed at most every interval (ms) unless
+// something important happened
+#define RECORDER_ADDRESS 64
+#define RECORDER_SLOTS 15
+#define RECORDER_INTERVAL 600000
+
+// watchdog timeout (WDTO_*), the driver resets straight into prepared when
+// the main loop stops feeding it or Jack crashes
+#define SUPERVISOR_TIMEOUT WDTO_2S
+
+// free bytes between heap and stack below which the monitor warns
+#define MONITOR_STACK_RESERVE 128
+
+// per module loop timing, dumped with 'p' over the debug log
+#define PROFILER false
+// trigger latency traces, reported with 't' over the debug log
+#define TRACER false
+// longest time interrupts were blocked, in the report of the debug log, takes
+// over timer 2
+#define BLACKOUT false
+
+// links Jacks along a path over RS-485 on the hardware serial, a Jack
+// triggered by motion triggers the others delayed by BUS_CASCADE ms per
+// address between them; 0 disables the bus, which needs DEBUG off
+#define BUS_ADDRESS 0
+#define BUS_BAUD 38400
+#define BUS_ENABLE_PIN 2
+#define BUS_CASCADE 400
+
 #define DEBUG true
-#define DSERIAL_BEGIN if (DEBUG) Serial.begin(9600)
-#define DSERIAL if (DEBUG) Serial
+#define DLOG_BEGIN if (DEBUG) logger.begin(9600)
+#define DLOG if (DEBUG) logger
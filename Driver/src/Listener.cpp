@@ -0,0 +1,212 @@
+#include "Listener.h"
+
+// ring buffer of averaged samples, 13 ms at 4.8 kHz
+#define RING 64
+#define RING_MASK (RING - 1)
+
+// samples per Goertzel block, bins are 50 Hz apart at 4.8 kHz
+#define BLOCK 96
+
+// the DAC output swings far less than the 5 V reference, levels are amplified
+// to reach 255 at an amplitude of 128 / GAIN counts
+#define GAIN 4
+
+static_assert((RING & RING_MASK) == 0, "ring must be a power of two");
+
+namespace {
+
+volatile uint8_t samples[RING];
+volatile uint8_t head = 0;
+volatile uint8_t tail = 0;
+volatile uint16_t lost = 0;
+
+// samples update() went through and the us it took
+uint16_t handled = 0;
+uint32_t busy = 0;
+
+// first sample of a pair
+uint8_t first;
+bool paired;
+
+uint8_t channel;
+bool listening = false;
+
+// 2 cos(2 pi k / BLOCK) in Q14 for the bins k = 3, 12 and 36
+const int16_t coefficients[Listener::Bands] PROGMEM = { 32138, 23170, -23170 };
+
+// running mean of the samples in Q6, removes the bias of the DAC output
+int16_t mean = 0;
+// peak of the rectified samples in Q8
+uint16_t envelope = 0;
+
+int16_t s1[Listener::Bands];
+int16_t s2[Listener::Bands];
+uint8_t position = 0;
+uint8_t magnitudes[Listener::Bands];
+
+uint8_t saturate(uint16_t value) {
+    return value > 255 ? 255 : value;
+}
+
+uint16_t root(uint32_t value) {
+    uint16_t result = 0;
+    for (uint16_t bit = 0x8000; bit != 0; bit >>= 1) {
+        uint16_t trial = result | bit;
+        if (uint32_t(trial) * trial <= value) {
+            result = trial;
+        }
+    }
+    return result;
+}
+
+// magnitudes at the end of a block, restarts the filters
+void measure(void) {
+    for (uint8_t band = 0; band < Listener::Bands; band++) {
+        int16_t coefficient = pgm_read_word(&coefficients[band]);
+        // scaled down so the power fits 32 bits
+        int32_t a = s1[band] >> 4;
+        int32_t b = s2[band] >> 4;
+        int32_t power = a * a + b * b - ((((a * b) >> 7) * coefficient) >> 7);
+        // a sine of amplitude A on the bin reaches BLOCK / 4 * A, scaled like
+        // the level
+        uint16_t magnitude = root(power > 0 ? power : 0) << 4;
+        magnitudes[band] = saturate(uint32_t(magnitude) * GAIN / (BLOCK / 8));
+        s1[band] = 0;
+        s2[band] = 0;
+    }
+}
+
+}
+
+ISR(ADC_vect) {
+    uint8_t sample = ADCH;
+    if (!paired) {
+        first = sample;
+        paired = true;
+        return;
+    }
+    paired = false;
+    uint8_t next = (head + 1) & RING_MASK;
+    if (next == tail) {
+        lost++;
+        return;
+    }
+    // averaging pairs damps the hiss band by a fifth, and aliasing
+    samples[head] = (uint16_t(first) + sample) >> 1;
+    head = next;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Listener::begin(uint8_t pin) {
+    channel = (pin - A0) & 0x07;
+    head = 0;
+    tail = 0;
+    lost = 0;
+    handled = 0;
+    busy = 0;
+    paired = false;
+    mean = 128 << 6;
+    envelope = 0;
+    position = 0;
+    for (uint8_t band = 0; band < Bands; band++) {
+        s1[band] = 0;
+        s2[band] = 0;
+        magnitudes[band] = 0;
+    }
+
+    // AVcc reference, left adjusted for 8 bits from ADCH
+    ADMUX = _BV(REFS0) | _BV(ADLAR) | channel;
+    ADCSRB = 0;
+    DIDR0 |= _BV(channel);
+    // free running at 16 MHz / 128 / 13 cycles per conversion
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+    listening = true;
+}
+
+void Listener::end() {
+    // as the core leaves it for analogRead()
+    ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+    DIDR0 &= ~_BV(channel);
+    envelope = 0;
+    for (uint8_t band = 0; band < Bands; band++) {
+        magnitudes[band] = 0;
+    }
+    listening = false;
+}
+
+bool Listener::isListening() {
+    return listening;
+}
+
+void Listener::update() {
+    uint32_t start = micros();
+    uint16_t taken = 0;
+    while (tail != head) {
+        taken++;
+        int16_t sample = samples[tail];
+        tail = (tail + 1) & RING_MASK;
+
+        mean += ((sample << 6) - mean) >> 6;
+        int16_t x = sample - (mean >> 6);
+
+        uint16_t target = uint16_t(x < 0 ? -x : x) << 8;
+        if (target > envelope) {
+            // attacks within a few samples, releases over about 100 ms
+            envelope += (target - envelope) >> 2;
+        }
+        else {
+            envelope -= (envelope - target) >> 9;
+        }
+
+        // Goertzel: s = x + 2 cos(w) s1 - s2, halved input keeps s in 16 bits
+        x >>= 1;
+        for (uint8_t band = 0; band < Bands; band++) {
+            int16_t coefficient = pgm_read_word(&coefficients[band]);
+            int16_t s = x + int16_t((int32_t(coefficient) * s1[band]) >> 14) - s2[band];
+            s2[band] = s1[band];
+            s1[band] = s;
+        }
+        if (++position == BLOCK) {
+            position = 0;
+            measure();
+        }
+    }
+    // both stop together, so the time per sample stays right
+    if (taken > 0 && handled <= 0xFFFF - taken) {
+        handled += taken;
+        busy += micros() - start;
+    }
+}
+
+uint8_t Listener::level() {
+    return saturate((envelope >> 8) * GAIN * 2);
+}
+
+uint8_t Listener::band(Band band) {
+    return band < Bands ? magnitudes[band] : 0;
+}
+
+uint16_t Listener::overruns() {
+    // the interrupt counts them
+    cli();
+    uint16_t result = lost;
+    sei();
+    return result;
+}
+
+uint16_t Listener::processed() {
+    return handled;
+}
+
+uint32_t Listener::spent() {
+    return busy;
+}
+
+void Listener::clear() {
+    cli();
+    lost = 0;
+    sei();
+    handled = 0;
+    busy = 0;
+}
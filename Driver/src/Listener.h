@@ -0,0 +1,53 @@
+#ifndef __LISTENER_H__
+#define __LISTENER_H__
+
+#include <Arduino.h>
+
+// Listens to the DAC output of the MP3 module on an analog pin. The ADC runs
+// free at 9.6 kHz, its interrupt averages pairs of 8 bit samples into a ring
+// buffer (4.8 kHz), and update() works the buffer off in fixed point: an
+// envelope follower for the loudness and Goertzel filters for a few bands,
+// computed sample by sample over blocks of 20 ms. There is one ADC, so the
+// listener is a single static instance.
+//
+// Estimated cost on the ATmega328 at 16 MHz: the interrupt takes about 50
+// cycles per conversion, update() about 200 cycles per sample and 2500 per
+// block, together about 1.6 M cycles per second or 10% of the CPU while
+// listening. These are counted from the code, not measured: the benchmarks
+// measure update() in cycles as listener.update, the report of the driver logs
+// the time update() took per sample on the board. The ADC interrupt also wakes
+// the sleeping CPU, so listen only while the LEDs follow the audio.
+
+class Listener {
+public:
+    enum Band : uint8_t {
+        Bass,   // 150 Hz
+        Voice,  // 600 Hz
+        Hiss,   // 1800 Hz
+        Bands
+    };
+
+    // Takes over the ADC and starts sampling the analog pin (A0 to A5).
+    static void begin(uint8_t pin);
+    // Stops sampling and releases the ADC.
+    static void end(void);
+    static bool isListening(void);
+
+    // Processes the samples taken since the last call, at least every 13 ms
+    // before the ring buffer overflows.
+    static void update(void);
+
+    // loudness from 0 to 255
+    static uint8_t level(void);
+    // magnitude of the band over the last block from 0 to 255
+    static uint8_t band(Band band);
+    // samples lost to a full ring buffer since begin() or the last clear()
+    static uint16_t overruns(void);
+    // samples processed by update() and the us it took for them since the
+    // last clear()
+    static uint16_t processed(void);
+    static uint32_t spent(void);
+    static void clear(void);
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "Logger.h"
+
+#define SYNC 0xA5
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Logger::Implementation {
+public:
+    Implementation(HardwareSerial& serial, uint8_t size)
+        : serial(serial), size(size), ring(new uint8_t[size]) {
+        head = 0;
+        tail = 0;
+        blocking = false;
+        dropped_count = 0;
+    }
+
+    ~Implementation() {
+        delete[] ring;
+    }
+
+    bool begin(unsigned long baud) {
+        serial.begin(baud);
+        return true;
+    }
+
+    bool loop() {
+        while (head != tail && serial.availableForWrite() > 0) {
+            serial.write(ring[tail]);
+            tail = (tail + 1) % size;
+        }
+        return true;
+    }
+
+    bool open(Message message, uint8_t length) {
+        uint8_t needed = length + 5;
+        if (needed >= size) {
+            return false;
+        }
+        if (blocking) {
+            while (free() < needed) {
+                loop();
+            }
+        }
+        if (free() < needed) {
+            if (dropped_count < 0xFFFF) {
+                dropped_count++;
+            }
+            return false;
+        }
+
+        uint16_t ms = millis();
+        put(SYNC);
+        put(uint8_t(message));
+        put(length);
+        put(ms & 0xFF);
+        put(ms >> 8);
+        return true;
+    }
+
+    void write(const void *data, uint8_t length) {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        while (length--) {
+            put(*bytes++);
+        }
+    }
+
+    void setBlocking(bool blocking) {
+        this->blocking = blocking;
+    }
+
+    bool isBlocking() {
+        return blocking;
+    }
+
+    uint8_t room() {
+        return free();
+    }
+
+    void flush() {
+        while (head != tail) {
+            loop();
+        }
+        serial.flush();
+    }
+
+    uint16_t dropped() {
+        return dropped_count;
+    }
+
+private:
+    HardwareSerial& serial;
+
+    uint8_t size;
+    uint8_t *ring;
+    uint8_t head;
+    uint8_t tail;
+
+    bool blocking;
+
+    uint16_t dropped_count;
+
+    uint8_t free() {
+        return (tail + size - head - 1) % size;
+    }
+
+    void put(uint8_t byte) {
+        ring[head] = byte;
+        head = (head + 1) % size;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Logger::Logger(HardwareSerial& serial, uint8_t size)
+    : impl(new Implementation(serial, size)) {
+}
+
+Logger::~Logger() {
+    delete impl;
+}
+
+bool Logger::begin(unsigned long baud) {
+    return impl->begin(baud);
+}
+
+bool Logger::loop() {
+    return impl->loop();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Logger::setBlocking(bool blocking) {
+    impl->setBlocking(blocking);
+}
+
+bool Logger::isBlocking() {
+    return impl->isBlocking();
+}
+
+void Logger::flush() {
+    impl->flush();
+}
+
+uint16_t Logger::dropped() {
+    return impl->dropped();
+}
+
+uint8_t Logger::room() {
+    return impl->room();
+}
+
+bool Logger::open(Message message, uint8_t length) {
+    return impl->open(message, length);
+}
+
+void Logger::write(const void *data, uint8_t length) {
+    impl->write(data, length);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
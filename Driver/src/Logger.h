@@ -0,0 +1,69 @@
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+#include <Arduino.h>
+
+#include "Messages.h"
+
+// Logs messages as binary records into a ring buffer which is drained to
+// the serial as far as its transmit buffer has room, so logging never waits
+// for the serial.
+//
+// Record: 0xA5, message id, argument length, 16 bit timestamp in ms, arguments
+// (all little endian).
+
+class Logger {
+    class Implementation;
+
+public:
+    Logger(HardwareSerial& serial, uint8_t size);
+    ~Logger();
+
+    bool begin(unsigned long baud);
+    bool loop(void);
+
+    template<typename... Arguments>
+    bool log(Message message, Arguments... arguments) {
+        if (!open(message, length(arguments...))) {
+            return false;
+        }
+        put(arguments...);
+        return true;
+    }
+
+    // Blocking logs wait for room instead of dropping messages, this is for
+    // dumps requested by the user.
+    void setBlocking(bool blocking);
+    bool isBlocking(void);
+
+    // Drains the ring buffer and waits for the serial.
+    void flush(void);
+
+    uint16_t dropped(void);
+    // bytes free in the ring buffer, a record takes 5 plus its arguments
+    uint8_t room(void);
+
+private:
+    Logger(const Logger&);
+    Logger& operator=(const Logger&);
+
+    bool open(Message message, uint8_t length);
+    void write(const void *data, uint8_t length);
+
+    static constexpr uint8_t length() { return 0; }
+    template<typename Argument, typename... Arguments>
+    static constexpr uint8_t length(Argument, Arguments... arguments) {
+        return sizeof(Argument) + length(arguments...);
+    }
+
+    void put() {}
+    template<typename Argument, typename... Arguments>
+    void put(Argument argument, Arguments... arguments) {
+        write(&argument, sizeof(Argument));
+        put(arguments...);
+    }
+
+    Implementation *impl;
+};
+
+#endif
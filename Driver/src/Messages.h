@@ -0,0 +1,71 @@
+#ifndef __MESSAGES_H__
+#define __MESSAGES_H__
+
+#include <Arduino.h>
+
+// Messages of the logger. Only the id and the arguments of a message are sent,
+// the texts stay on the host, see tools/messages.py and tools/logdecode.py.
+//
+// Placeholders:
+//  %u  16 bit unsigned
+//  %U  32 bit unsigned
+//  %b   8 bit unsigned
+//  %s   8 bit index into one of the NAMES lists, written as %s(list)
+
+#define MESSAGES(M) \
+    M(Setup,          "Jack Setup ...") \
+    M(Warmup,         "Jack Warmup ...") \
+    M(Running,        "Jack In-The-Box running ...") \
+    M(Transition,     "Jack goes from %s(state) to %s(state)") \
+    M(Crashed,        "Jack crashed ...") \
+    M(Failed,         "Jack failed by %s(reason) in %s(state) at %s(module), recovery %u") \
+    M(Recovered,      "Jack recovered in %Ums") \
+    M(Idle,           "Jack idles %b%") \
+    M(Task,           "Task %b runs %u overruns %u longest %uus") \
+    M(Sleep,          "Jack slept %u times, woke up in %uus, at most %uus of %uus") \
+    M(SleepSlow,      "Jack wakes up too slowly ...") \
+    M(Consumption,    "Jack draws about %bmA awake, %bmA asleep") \
+    M(ProfilerCost,   "Profiler costs %uus per call") \
+    M(Profile,        "Profile %s(module) calls %u min %u mean %u max %uus") \
+    M(ProfileBin,     "  <%uus %b") \
+    M(ProfileRest,    "  longer %b") \
+    M(Capturing,      "Capturing inputs %b") \
+    M(Edge,           "Edge %b %b %u") \
+    M(Traced,         "Traced %b triggers") \
+    M(Trace,          "Trace %s(stage) p50 %U p90 %U max %Uus") \
+    M(Memory,         "Memory %u free, at least %u, heap %u with %b free blocks of %u, largest %u") \
+    M(Power,          "LEDs draw about %umA of %umA, %u frames dimmed") \
+    M(Frames,         "LEDs showed %u frames %uus off the period on average, %uus at most, %u not rendered ahead") \
+    M(Streamed,       "Streamed %u frames at %b fps, dropped %u") \
+    M(Listened,       "Listener took %Uus for %u samples, lost %u") \
+    M(Blackout,       "Interrupts blocked for up to %uus") \
+    M(StackLow,       "Stack came within %u bytes of the heap") \
+    M(Dropped,        "Logger dropped %u messages") \
+    M(Recorded,       "Jack fired %U times, crashed %u times, ran %Us") \
+    M(RecordedState,  "Jack spent %Us %s(state)") \
+    M(RecordedFired,  "Jack fired at %Us") \
+    M(Configured,     "%s(field) = %u") \
+    M(Rejected,       "%s(field) rejects %u") \
+    M(NotNumber,      "Value is not a number") \
+    M(Saved,          "Configuration saved") \
+    M(Defaulted,      "Configuration reset to defaults") \
+    M(Unknown,        "Unknown command")
+
+#define NAMES(N) \
+    N(state,  "installed", "prepared", "mounted", "equipped", "triggered", "stopped", "crashed", \
+              "equipped_held") \
+    N(module, "button", "receptor", "states", "activator", "choreographer", "indicator", "enunciator", \
+              "sleeper", "recorder", "logger", "bus") \
+    N(reason, "none", "hang", "crash") \
+    N(stage,  "sensed", "triggered", "released", "laughed", "shown") \
+    N(field,  "volume", "brightness", "button_debounce", "receptor_debounce", "servo_released", \
+              "servo_restrained", "clear_time", "perform_time", "hold_time")
+
+enum class Message : uint8_t {
+#define MESSAGE_ID(id, format) id,
+    MESSAGES(MESSAGE_ID)
+#undef MESSAGE_ID
+    Messages
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "Monitor.h"
+
+#define PAINT 0xC5
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// lowest byte touched by the stack
+uint8_t *watermark = nullptr;
+
+uint8_t *heap_end() {
+    return (uint8_t *)(__brkval ? __brkval : &__heap_start);
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Monitor::paint() {
+    uint8_t *top = (uint8_t *)SP;
+    for (uint8_t *memory = heap_end(); memory < top; memory++) {
+        *memory = PAINT;
+    }
+    watermark = top;
+}
+
+// Scans upwards, locals which were never written leave painted holes in
+// the stack.
+uint16_t Monitor::check() {
+    uint8_t *bottom = heap_end();
+    if (watermark == nullptr || watermark < bottom) {
+        return 0;
+    }
+    for (uint8_t *memory = bottom; memory < watermark; memory++) {
+        if (*memory != PAINT) {
+            watermark = memory;
+            break;
+        }
+    }
+    return watermark - bottom;
+}
+
+Monitor::memory_t Monitor::memory() {
+    memory_t memory = { 0, 0, 0, 0, 0, 0 };
+    uint8_t *bottom = heap_end();
+    uint8_t *top = (uint8_t *)SP;
+    memory.free = top > bottom ? top - bottom : 0;
+    memory.lowest = check();
+    memory.heap = bottom - (uint8_t *)&__heap_start;
+    for (freelist_t *block = __flp; block; block = block->next) {
+        if (memory.blocks < 0xFF) {
+            memory.blocks++;
+        }
+        memory.released += block->size;
+        if (block->size > memory.largest) {
+            memory.largest = block->size;
+        }
+    }
+    return memory;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,44 @@
+#ifndef __MONITOR_H__
+#define __MONITOR_H__
+
+#include <Arduino.h>
+
+// Watches the memory between heap and stack. The free memory is painted at
+// startup, the lowest byte the stack (or the heap) ever touched marks the high
+// water. Memory is global, so the monitor is a single static instance.
+
+// free list and bounds of the heap, see malloc() of avr-libc
+struct freelist_t {
+    size_t size;
+    freelist_t *next;
+};
+
+extern "C" {
+extern char __heap_start;
+extern char *__brkval;
+extern freelist_t *__flp;
+}
+
+class Monitor {
+public:
+    struct memory_t {
+        // free bytes between heap and stack now and at the high water
+        uint16_t free;
+        uint16_t lowest;
+        // bytes of the heap, free blocks in it and the largest of those
+        uint16_t heap;
+        uint8_t blocks;
+        uint16_t released;
+        uint16_t largest;
+    };
+
+    // Paints the free memory, has to be called first in setup().
+    static void paint(void);
+
+    // Scans for the high water, returns the lowest free bytes so far.
+    static uint16_t check(void);
+
+    static memory_t memory(void);
+};
+
+#endif
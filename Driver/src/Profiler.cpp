@@ -0,0 +1,133 @@
+#include "Profiler.h"
+
+#define CALIBRATION_ROUNDS 16
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Profiler::Implementation {
+public:
+    Implementation(uint8_t count)
+        : count(count), profiles(new profile_t[count]) {
+        calibration = 0;
+        clear();
+    }
+
+    ~Implementation() {
+        delete[] profiles;
+    }
+
+    bool begin() {
+        // measure the profiler by profiling nothing
+        uint16_t overhead = 0;
+        for (uint8_t round = 0; round < CALIBRATION_ROUNDS; round++) {
+            uint16_t outer = start();
+            uint16_t inner = start();
+            measure(inner);
+            overhead += measure(outer);
+        }
+        calibration = overhead / CALIBRATION_ROUNDS;
+        return true;
+    }
+
+    uint16_t start() {
+        return micros();
+    }
+
+    void stop(uint8_t number, uint16_t started) {
+        if (number >= count) {
+            return;
+        }
+        uint16_t duration = measure(started);
+        duration = duration > calibration ? duration - calibration : 0;
+
+        profile_t& profile = profiles[number];
+        if (profile.count == 0xFFFF) {
+            profile.count >>= 1;
+            profile.total >>= 1;
+        }
+        profile.count++;
+        profile.total += duration;
+        if (duration < profile.minimum) {
+            profile.minimum = duration;
+        }
+        if (duration > profile.maximum) {
+            profile.maximum = duration;
+        }
+
+        uint8_t bin = 0;
+        for (duration /= FirstBin; duration && bin < Bins - 1; duration >>= 1) {
+            bin++;
+        }
+        if (profile.bin(bin) == 0x0F) {
+            // keep the shape of the histogram by halving all bins
+            for (uint8_t index = 0; index < Bins / 2; index++) {
+                profile.histogram[index] = (profile.histogram[index] >> 1) & 0x77;
+            }
+        }
+        profile.histogram[bin >> 1] += (bin & 1) ? 0x10 : 0x01;
+    }
+
+    const profile_t& profile(uint8_t number) {
+        return profiles[number < count ? number : 0];
+    }
+
+    uint16_t overhead() {
+        return calibration;
+    }
+
+    void clear() {
+        for (uint8_t index = 0; index < count; index++) {
+            memset(&profiles[index], 0, sizeof(profile_t));
+            profiles[index].minimum = 0xFFFF;
+        }
+    }
+
+private:
+    uint8_t count;
+
+    profile_t *profiles;
+
+    uint16_t calibration;
+
+    uint16_t measure(uint16_t started) {
+        return uint16_t(micros()) - started;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Profiler::Profiler(uint8_t count)
+    : impl(new Implementation(count)) {
+}
+
+Profiler::~Profiler() {
+    delete impl;
+}
+
+bool Profiler::begin() {
+    return impl->begin();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint16_t Profiler::start() {
+    return impl->start();
+}
+
+void Profiler::stop(uint8_t number, uint16_t started) {
+    impl->stop(number, started);
+}
+
+const Profiler::profile_t& Profiler::profile(uint8_t number) {
+    return impl->profile(number);
+}
+
+uint16_t Profiler::overhead() {
+    return impl->overhead();
+}
+
+void Profiler::clear() {
+    impl->clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
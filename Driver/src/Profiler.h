@@ -0,0 +1,62 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <Arduino.h>
+
+#include "Jack.h"
+
+// Times come from micros(), in steps of 4 us at 16 MHz: timer 0 runs millis(),
+// timer 1 the servo and timer 2 the blackout meter, so no timer is left for a
+// finer clock. Calls shorter than the step count as 0 or 4 us.
+
+class Profiler {
+    class Implementation;
+
+public:
+    enum { Bins = 8, FirstBin = 16 };
+
+    struct profile_t {
+        // halved with the total once it runs full, so the mean stays right
+        uint16_t count;
+        uint16_t minimum;
+        uint16_t maximum;
+        uint32_t total;
+        // 4 bit counts, bin n counts calls taking less than FirstBin << n
+        // microseconds, the last bin all longer calls
+        uint8_t histogram[Bins / 2];
+
+        uint8_t bin(uint8_t number) const {
+            return (histogram[number >> 1] >> ((number & 1) * 4)) & 0x0F;
+        }
+    };
+
+    Profiler(uint8_t count);
+    ~Profiler();
+
+    bool begin(void);
+
+    uint16_t start(void);
+    void stop(uint8_t number, uint16_t started);
+
+    const profile_t& profile(uint8_t number);
+    // cost of one start/stop pair in microseconds, already subtracted
+    uint16_t overhead(void);
+
+    void clear(void);
+
+private:
+    Profiler(const Profiler&);
+    Profiler& operator=(const Profiler&);
+
+    Implementation *impl;
+};
+
+// Measures a statement, compiles to just the statement without PROFILER.
+#if PROFILER
+#define PROFILE(number, statement) \
+    { uint16_t profile_started = profiler.start(); statement; profiler.stop(number, profile_started); }
+#else
+#define PROFILE(number, statement) statement
+#endif
+
+#endif
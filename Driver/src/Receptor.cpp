@@ -1,15 +1,16 @@
 #include "Receptor.h"
 
+#include "Timer.h"
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Receptor::Implementation {
 public:
-    Implementation(uint8_t pin, PullUp enablePullUp, uint32_t debounceTime)
+    Implementation(uint8_t pin, PullUp enablePullUp, uint16_t debounceTime)
         : pin(pin), pinPullUp(bool(enablePullUp)), debounceTime(debounceTime) {
+        reader = digitalRead;
         state = false;
-        stateMillis = millis();
         stateChanged = false;
-        stateChangedMillis = stateMillis;
         lastState = state;
     }
 
@@ -21,26 +22,26 @@ public:
             pinMode(pin, INPUT);
         }
 
-        state = (digitalRead(pin) == HIGH);
+        state = (reader(pin) == HIGH);
+        debounce.start(debounceTime);
 
         return true;
     }
 
     bool loop(void) {
-        uint32_t ms = millis();
-        if (stateMillis - stateChangedMillis >= debounceTime) {
+        // ignores the pin until it settled after a change
+        if (!debounce.isRunning()) {
             lastState = state;
 
-            state = (digitalRead(pin) == HIGH);
+            state = (reader(pin) == HIGH);
             stateChanged = (state != lastState);
             if (stateChanged) {
-                stateChangedMillis = ms;
+                debounce.start(debounceTime);
             }
         }
         else {
             stateChanged = false;
         }
-        stateMillis = ms;
         return state;
     }
 
@@ -56,22 +57,31 @@ public:
         return state && stateChanged;
     }
 
+    void setDebounceTime(uint16_t debounceTime) {
+        this->debounceTime = debounceTime;
+    }
+
+    void setReader(reader_t reader) {
+        this->reader = reader;
+    }
+
 private:
     uint8_t pin;
     uint8_t pinPullUp;
-    uint32_t debounceTime;
+    uint16_t debounceTime;
+    reader_t reader;
 
     bool state;
     bool stateChanged;
-    uint32_t stateMillis;
-    uint32_t stateChangedMillis;
+    // started at each change
+    Timer debounce;
 
     bool lastState;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-Receptor::Receptor(uint8_t pin, PullUp enablePullUp, uint32_t debounceTime)
+Receptor::Receptor(uint8_t pin, PullUp enablePullUp, uint16_t debounceTime)
     : impl(new Implementation(pin, enablePullUp, debounceTime)) {
 }
 
@@ -99,4 +109,12 @@ bool Receptor::sensedMotion() {
     return impl->sensedMotion();
 }
 
+void Receptor::setDebounceTime(uint16_t debounceTime) {
+    impl->setDebounceTime(debounceTime);
+}
+
+void Receptor::setReader(reader_t reader) {
+    impl->setReader(reader);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,7 +9,10 @@ class Receptor {
 public:
     enum class PullUp : bool { Disable, Enable };
 
-    Receptor(uint8_t pin, PullUp enablePullUp, uint32_t debounceTime);
+    // reads the level of a pin, digitalRead by default
+    typedef int (*reader_t)(uint8_t pin);
+
+    Receptor(uint8_t pin, PullUp enablePullUp, uint16_t debounceTime);
     ~Receptor();
 
     bool begin(void);
@@ -20,6 +23,9 @@ public:
 
     bool sensedMotion(void);
 
+    void setDebounceTime(uint16_t debounceTime);
+    void setReader(reader_t reader);
+
 private:
     Receptor(const Receptor&);
     Receptor& operator=(const Receptor&);
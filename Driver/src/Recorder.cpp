@@ -0,0 +1,193 @@
+#include "Recorder.h"
+
+#include <EEPROM.h>
+#include <stddef.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+static_assert(sizeof(Recorder::record_t) <= Recorder::SlotSize, "record must fit into a slot");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Recorder::Implementation {
+public:
+    Implementation(uint16_t address, uint8_t slots, uint32_t interval)
+        : address(address), slots(slots), interval(interval) {
+        memset(&current, 0, sizeof(current));
+        memset(remainders, 0, sizeof(remainders));
+        slot = slots - 1;
+        dirty = false;
+        urgent = false;
+        deferred = false;
+        writing = false;
+    }
+
+    bool begin() {
+        // find the most recent valid record
+        bool found = false;
+        record_t candidate;
+        for (uint8_t index = 0; index < slots; index++) {
+            EEPROM.get(address + index * SlotSize, candidate);
+            if (candidate.checksum != checksum(candidate)) {
+                continue;
+            }
+            if (!found || int16_t(candidate.sequence - current.sequence) > 0) {
+                current = candidate;
+                slot = index;
+                found = true;
+            }
+        }
+        committed = millis();
+        return true;
+    }
+
+    bool loop() {
+        if (writing) {
+            write();
+            return true;
+        }
+        if (!dirty || deferred) {
+            return true;
+        }
+        if (urgent || millis() - committed >= interval) {
+            // the snapshot is written while counting goes on
+            current.sequence++;
+            current.checksum = checksum(current);
+            snapshot = current;
+            slot = (slot + 1) % slots;
+            position = 0;
+            writing = true;
+            dirty = false;
+            urgent = false;
+            committed = millis();
+        }
+        return true;
+    }
+
+    void spend(uint8_t state, uint32_t ms) {
+        if (state >= States) {
+            return;
+        }
+        ms += remainders[state];
+        current.seconds[state] += ms / 1000;
+        remainders[state] = ms % 1000;
+        dirty = true;
+    }
+
+    void countTrigger() {
+        current.triggers++;
+        memmove(&current.history[1], &current.history[0], sizeof(current.history[0]) * (History - 1));
+        current.history[0] = lifetime();
+        dirty = true;
+        urgent = true;
+    }
+
+    void countCrash() {
+        current.crashes++;
+        dirty = true;
+        urgent = true;
+    }
+
+    void setDeferred(bool deferred) {
+        this->deferred = deferred;
+    }
+
+    const record_t& record() {
+        return current;
+    }
+
+    uint32_t lifetime() {
+        uint32_t seconds = 0;
+        for (uint8_t state = 0; state < States; state++) {
+            seconds += current.seconds[state];
+        }
+        return seconds;
+    }
+
+private:
+    uint16_t address;
+    uint8_t slots;
+    uint32_t interval;
+
+    record_t current;
+    uint16_t remainders[States];
+
+    uint8_t slot;
+    uint32_t committed;
+
+    bool dirty;
+    bool urgent;
+    bool deferred;
+
+    bool writing;
+    record_t snapshot;
+    uint8_t position;
+
+    void write() {
+        if (!eeprom_is_ready()) {
+            return;
+        }
+        // the checksum is the last byte of the record, so a commit
+        // interrupted by a reset leaves an invalid record behind
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&snapshot);
+        EEPROM.update(address + slot * SlotSize + position, bytes[position]);
+        if (++position == sizeof(record_t)) {
+            writing = false;
+        }
+    }
+
+    static uint8_t checksum(const record_t& record) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&record);
+        uint8_t crc = 0;
+        for (uint8_t index = 0; index < offsetof(record_t, checksum); index++) {
+            crc = _crc8_ccitt_update(crc, bytes[index]);
+        }
+        return crc;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Recorder::Recorder(uint16_t address, uint8_t slots, uint32_t interval)
+    : impl(new Implementation(address, slots, interval)) {
+}
+
+Recorder::~Recorder() {
+    delete impl;
+}
+
+bool Recorder::begin() {
+    return impl->begin();
+}
+
+bool Recorder::loop() {
+    return impl->loop();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::spend(uint8_t state, uint32_t ms) {
+    impl->spend(state, ms);
+}
+
+void Recorder::countTrigger() {
+    impl->countTrigger();
+}
+
+void Recorder::countCrash() {
+    impl->countCrash();
+}
+
+void Recorder::setDeferred(bool deferred) {
+    impl->setDeferred(deferred);
+}
+
+const Recorder::record_t& Recorder::record() {
+    return impl->record();
+}
+
+uint32_t Recorder::lifetime() {
+    return impl->lifetime();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
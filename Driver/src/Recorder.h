@@ -0,0 +1,54 @@
+#ifndef __RECORDER_H__
+#define __RECORDER_H__
+
+#include <Arduino.h>
+
+// Keeps event counters and history in EEPROM.
+//
+// Records are written round robin into a number of slots, so every commit
+// goes to another slot and the cells wear evenly. The record with the
+// highest sequence number and a valid checksum is the current one. Commits
+// are spread over many loops, one byte whenever the EEPROM is ready, so
+// they never wait for the EEPROM.
+
+class Recorder {
+    class Implementation;
+
+public:
+    enum { States = 8, History = 4, SlotSize = 64 };
+
+    struct record_t {
+        uint16_t sequence;
+        uint32_t triggers;
+        uint16_t crashes;
+        // seconds spent per state
+        uint32_t seconds[States];
+        // lifetime in seconds of the last triggers, most recent first
+        uint32_t history[History];
+        uint8_t checksum;
+    };
+
+    Recorder(uint16_t address, uint8_t slots, uint32_t interval);
+    ~Recorder();
+
+    bool begin(void);
+    bool loop(void);
+
+    void spend(uint8_t state, uint32_t ms);
+    void countTrigger(void);
+    void countCrash(void);
+
+    // commits are held back while deferred
+    void setDeferred(bool deferred);
+
+    const record_t& record(void);
+    uint32_t lifetime(void);
+
+private:
+    Recorder(const Recorder&);
+    Recorder& operator=(const Recorder&);
+
+    Implementation *impl;
+};
+
+#endif
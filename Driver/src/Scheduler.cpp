@@ -0,0 +1,189 @@
+#include "Scheduler.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct entry_t {
+    Scheduler::task_t task;
+    uint16_t period;
+    uint16_t deadline;
+    uint8_t priority;
+    // time of the next release, wraps after a minute which is fine as long
+    // as periods stay below half of that
+    uint16_t release;
+
+    Scheduler::statistics_t statistics;
+};
+
+class Scheduler::Implementation {
+public:
+    Implementation(uint8_t capacity)
+        : capacity(capacity), entries(new entry_t[capacity]) {
+        entries_count = 0;
+        idling = false;
+    }
+
+    ~Implementation() {
+        delete[] entries;
+    }
+
+    bool begin() {
+        uint16_t ms = millis();
+        for (uint8_t index = 0; index < entries_count; index++) {
+            entries[index].release = ms;
+        }
+        clear();
+        return true;
+    }
+
+    bool loop() {
+        uint16_t ms = millis();
+
+        // pick the most urgent of the released tasks
+        entry_t *next = 0;
+        for (uint8_t index = 0; index < entries_count; index++) {
+            entry_t *entry = &entries[index];
+            if (int16_t(ms - entry->release) < 0) {
+                continue;
+            }
+            if (next == 0 || entry->priority > next->priority ||
+                (entry->priority == next->priority &&
+                 int16_t((entry->release + entry->deadline) - (next->release + next->deadline)) < 0)) {
+                next = entry;
+            }
+        }
+        idling = (next == 0);
+        if (idling) {
+            return true;
+        }
+
+        uint32_t start = micros();
+        next->task();
+        uint32_t duration = micros() - start;
+
+        busy += duration;
+
+        statistics_t& statistics = next->statistics;
+        if (statistics.runs < 0xFFFF) {
+            statistics.runs++;
+        }
+        if (duration > statistics.longest) {
+            statistics.longest = duration > 0xFFFF ? 0xFFFF : duration;
+        }
+        ms = millis();
+        if (uint16_t(ms - next->release) > next->deadline) {
+            if (statistics.overruns < 0xFFFF) {
+                statistics.overruns++;
+            }
+        }
+
+        // keep the phase, but skip releases that have already been missed
+        next->release += next->period;
+        if (int16_t(ms - next->release) >= int16_t(next->period)) {
+            next->release = ms;
+        }
+        return true;
+    }
+
+    uint8_t add(task_t task, uint16_t period, uint16_t deadline, uint8_t priority) {
+        if (entries_count == capacity) {
+            return 0xFF;
+        }
+        entry_t *entry = &entries[entries_count];
+        entry->task = task;
+        entry->period = period;
+        entry->deadline = deadline;
+        entry->priority = priority;
+        entry->release = millis();
+        entry->statistics = statistics_t();
+        return entries_count++;
+    }
+
+    uint8_t count() {
+        return entries_count;
+    }
+
+    bool isIdle() {
+        return idling;
+    }
+
+    statistics_t statistics(uint8_t number) {
+        if (number < entries_count) {
+            return entries[number].statistics;
+        }
+        return statistics_t();
+    }
+
+    uint8_t idle() {
+        uint32_t window = micros() - window_start;
+        if (window == 0 || busy >= window) {
+            return 0;
+        }
+        return 100 - (busy * 100) / window;
+    }
+
+    void clear() {
+        for (uint8_t index = 0; index < entries_count; index++) {
+            entries[index].statistics = statistics_t();
+        }
+        busy = 0;
+        window_start = micros();
+    }
+
+private:
+    uint8_t capacity;
+
+    entry_t *entries;
+    uint8_t entries_count;
+
+    bool idling;
+
+    // time spent in tasks since window_start
+    uint32_t busy;
+    uint32_t window_start;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Scheduler::Scheduler(uint8_t capacity)
+    : impl(new Implementation(capacity)) {
+}
+
+Scheduler::~Scheduler() {
+    delete impl;
+}
+
+bool Scheduler::begin() {
+    return impl->begin();
+}
+
+bool Scheduler::loop() {
+    return impl->loop();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint8_t Scheduler::add(task_t task, uint16_t period, uint16_t deadline, uint8_t priority) {
+    return impl->add(task, period, deadline, priority);
+}
+
+uint8_t Scheduler::count() {
+    return impl->count();
+}
+
+bool Scheduler::isIdle() {
+    return impl->isIdle();
+}
+
+Scheduler::statistics_t Scheduler::statistics(uint8_t number) {
+    return impl->statistics(number);
+}
+
+uint8_t Scheduler::idle() {
+    return impl->idle();
+}
+
+void Scheduler::clear() {
+    impl->clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,50 @@
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <Arduino.h>
+
+class Scheduler {
+    class Implementation;
+
+public:
+    typedef void (*task_t)(void);
+
+    struct statistics_t {
+        // completed runs
+        uint16_t runs;
+        // runs finished later than their deadline
+        uint16_t overruns;
+        // longest run in microseconds
+        uint16_t longest;
+    };
+
+    Scheduler(uint8_t capacity);
+    ~Scheduler();
+
+    bool begin(void);
+    bool loop(void);
+
+    // Adds a task released every period milliseconds which has to finish
+    // within deadline milliseconds after its release. When several tasks
+    // are due the one with the highest priority runs first. Returns the
+    // number of the task.
+    uint8_t add(task_t task, uint16_t period, uint16_t deadline, uint8_t priority);
+
+    uint8_t count(void);
+
+    // true if the last loop found no task to run
+    bool isIdle(void);
+
+    // statistics since the last call to clear()
+    statistics_t statistics(uint8_t number);
+    uint8_t idle(void);
+    void clear(void);
+
+private:
+    Scheduler(const Scheduler&);
+    Scheduler& operator=(const Scheduler&);
+
+    Implementation *impl;
+};
+
+#endif
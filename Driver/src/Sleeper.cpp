@@ -0,0 +1,155 @@
+#include "Sleeper.h"
+
+#include <avr/sleep.h>
+
+// Start-up time from power down, the crystal oscillator fuses of the pro mini
+// select 16K clock cycles. Timer 0 is stopped during that time, so it is added
+// to the measured latency.
+#define WAKEUP_CYCLES 16384UL
+#define WAKEUP_MICROS (WAKEUP_CYCLES / (F_CPU / 1000000UL))
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Sleeper::Implementation {
+public:
+    Implementation(uint8_t sensorPin, uint8_t buttonPin)
+        : sensorPin(sensorPin), buttonPin(buttonPin) {
+        sleeps_count = 0;
+        woken = false;
+        last_latency = 0;
+        longest_latency = 0;
+    }
+
+    bool begin() {
+        return true;
+    }
+
+    void idle() {
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode();
+    }
+
+    void powerDown() {
+        // Wakes up by pin change interrupts. The interrupt vectors are claimed
+        // by SoftwareSerial, its handler ignores changes on pins it does not
+        // listen to, which is all that is needed to wake up.
+        uint8_t pcicr = PCICR;
+        enable(sensorPin);
+        enable(buttonPin);
+
+        // a change right before the interrupts were enabled would be missed
+        if (digitalRead(sensorPin) == HIGH || digitalRead(buttonPin) == LOW) {
+            restore(pcicr);
+            return;
+        }
+
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        cli();
+        sleep_enable();
+        #ifdef sleep_bod_disable
+        sleep_bod_disable();
+        #endif
+        sei();
+        sleep_cpu();
+        sleep_disable();
+
+        woke = micros();
+        woken = true;
+        if (sleeps_count < 0xFFFF) {
+            sleeps_count++;
+        }
+
+        restore(pcicr);
+    }
+
+    void measure() {
+        if (!woken) {
+            return;
+        }
+        woken = false;
+
+        uint32_t latency = micros() - woke + WAKEUP_MICROS;
+        last_latency = latency > 0xFFFF ? 0xFFFF : latency;
+        if (last_latency > longest_latency) {
+            longest_latency = last_latency;
+        }
+    }
+
+    uint16_t sleeps() {
+        return sleeps_count;
+    }
+
+    uint16_t latency() {
+        return last_latency;
+    }
+
+    uint16_t longestLatency() {
+        return longest_latency;
+    }
+
+private:
+    uint8_t sensorPin;
+    uint8_t buttonPin;
+
+    uint16_t sleeps_count;
+
+    bool woken;
+    uint32_t woke;
+
+    uint16_t last_latency;
+    uint16_t longest_latency;
+
+    void enable(uint8_t pin) {
+        *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+        PCIFR = _BV(digitalPinToPCICRbit(pin));
+        *digitalPinToPCICR(pin) |= _BV(digitalPinToPCICRbit(pin));
+    }
+
+    void restore(uint8_t pcicr) {
+        *digitalPinToPCMSK(sensorPin) &= ~_BV(digitalPinToPCMSKbit(sensorPin));
+        *digitalPinToPCMSK(buttonPin) &= ~_BV(digitalPinToPCMSKbit(buttonPin));
+        PCICR = pcicr;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Sleeper::Sleeper(uint8_t sensorPin, uint8_t buttonPin)
+    : impl(new Implementation(sensorPin, buttonPin)) {
+}
+
+Sleeper::~Sleeper() {
+    delete impl;
+}
+
+bool Sleeper::begin() {
+    return impl->begin();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Sleeper::idle() {
+    impl->idle();
+}
+
+void Sleeper::powerDown() {
+    impl->powerDown();
+}
+
+void Sleeper::measure() {
+    impl->measure();
+}
+
+uint16_t Sleeper::sleeps() {
+    return impl->sleeps();
+}
+
+uint16_t Sleeper::latency() {
+    return impl->latency();
+}
+
+uint16_t Sleeper::longestLatency() {
+    return impl->longestLatency();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
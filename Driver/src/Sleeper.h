@@ -0,0 +1,36 @@
+#ifndef __SLEEPER_H__
+#define __SLEEPER_H__
+
+#include <Arduino.h>
+
+class Sleeper {
+    class Implementation;
+
+public:
+    Sleeper(uint8_t sensorPin, uint8_t buttonPin);
+    ~Sleeper();
+
+    bool begin(void);
+
+    // Sleeps until the next interrupt, timers keep running.
+    void idle(void);
+    // Powers down until the sensor or the button pin changes, timers stop.
+    void powerDown(void);
+
+    // Marks the reaction to the last power down, the time it took since the
+    // wake up is kept as latency.
+    void measure(void);
+
+    uint16_t sleeps(void);
+    // latencies in microseconds, including the oscillator start-up
+    uint16_t latency(void);
+    uint16_t longestLatency(void);
+
+private:
+    Sleeper(const Sleeper&);
+    Sleeper& operator=(const Sleeper&);
+
+    Implementation *impl;
+};
+
+#endif
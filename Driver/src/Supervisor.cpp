@@ -0,0 +1,222 @@
+#include "Supervisor.h"
+
+#include <avr/wdt.h>
+
+#define MAGIC 0x4A4B
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// survives resets (but not power cycles), validated by its magic
+struct postmortem_t {
+    uint16_t magic;
+    Supervisor::Reason reason;
+    uint8_t state;
+    uint8_t module;
+    uint16_t recoveries;
+    uint32_t failed;
+    // ms from the failure until the reset
+    uint32_t downtime;
+};
+
+postmortem_t postmortem __attribute__((section(".noinit")));
+
+}
+
+ISR(WDT_vect) {
+    if (postmortem.reason == Supervisor::Reason::None) {
+        postmortem.reason = Supervisor::Reason::Hang;
+        postmortem.failed = millis();
+    }
+    postmortem.downtime = millis() - postmortem.failed;
+    postmortem.magic = MAGIC;
+
+    // reset right away instead of waiting for the next timeout
+    wdt_enable(WDTO_15MS);
+    for (;;);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Supervisor::Implementation {
+public:
+    Implementation(uint8_t timeout)
+        : timeout(timeout) {
+        recovered = false;
+        recovery_time = 0;
+        failing = false;
+    }
+
+    bool begin() {
+        MCUSR = 0;
+        wdt_disable();
+
+        if (postmortem.magic == MAGIC && postmortem.reason != Reason::None) {
+            recovered = true;
+            last_reason = postmortem.reason;
+            last_state = postmortem.state;
+            last_module = postmortem.module;
+            postmortem.recoveries++;
+        }
+        else {
+            postmortem.recoveries = 0;
+            postmortem.downtime = 0;
+        }
+        postmortem.magic = MAGIC;
+        postmortem.reason = Reason::None;
+
+        arm();
+        return recovered;
+    }
+
+    void feed() {
+        if (!failing) {
+            wdt_reset();
+        }
+    }
+
+    void enter(uint8_t module) {
+        postmortem.module = module;
+    }
+
+    void track(uint8_t state) {
+        postmortem.state = state;
+    }
+
+    void fail(Reason reason) {
+        if (failing) {
+            return;
+        }
+        failing = true;
+        postmortem.failed = millis();
+        postmortem.reason = reason;
+    }
+
+    void suspend() {
+        wdt_disable();
+    }
+
+    void resume() {
+        arm();
+    }
+
+    bool recover() {
+        if (!recovered || recovery_time != 0) {
+            return false;
+        }
+        recovery_time = postmortem.downtime + millis();
+        return true;
+    }
+
+    bool hasRecovered() {
+        return recovered;
+    }
+
+    Reason reason() {
+        return last_reason;
+    }
+
+    uint8_t state() {
+        return last_state;
+    }
+
+    uint8_t module() {
+        return last_module;
+    }
+
+    uint16_t recoveries() {
+        return postmortem.recoveries;
+    }
+
+    uint32_t recoveryTime() {
+        return recovery_time;
+    }
+
+private:
+    uint8_t timeout;
+
+    bool recovered;
+    Reason last_reason;
+    uint8_t last_state;
+    uint8_t last_module;
+    uint32_t recovery_time;
+
+    bool failing;
+
+    void arm() {
+        // interrupt first to write the postmortem, reset on the next timeout
+        wdt_enable(timeout);
+        WDTCSR |= _BV(WDIE);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Supervisor::Supervisor(uint8_t timeout)
+    : impl(new Implementation(timeout)) {
+}
+
+Supervisor::~Supervisor() {
+    delete impl;
+}
+
+bool Supervisor::begin() {
+    return impl->begin();
+}
+
+void Supervisor::feed() {
+    impl->feed();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Supervisor::enter(uint8_t module) {
+    impl->enter(module);
+}
+
+void Supervisor::track(uint8_t state) {
+    impl->track(state);
+}
+
+void Supervisor::fail(Reason reason) {
+    impl->fail(reason);
+}
+
+void Supervisor::suspend() {
+    impl->suspend();
+}
+
+void Supervisor::resume() {
+    impl->resume();
+}
+
+bool Supervisor::recover() {
+    return impl->recover();
+}
+
+bool Supervisor::hasRecovered() {
+    return impl->hasRecovered();
+}
+
+Supervisor::Reason Supervisor::reason() {
+    return impl->reason();
+}
+
+uint8_t Supervisor::state() {
+    return impl->state();
+}
+
+uint8_t Supervisor::module() {
+    return impl->module();
+}
+
+uint16_t Supervisor::recoveries() {
+    return impl->recoveries();
+}
+
+uint32_t Supervisor::recoveryTime() {
+    return impl->recoveryTime();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
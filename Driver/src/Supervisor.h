@@ -0,0 +1,58 @@
+#ifndef __SUPERVISOR_H__
+#define __SUPERVISOR_H__
+
+#include <Arduino.h>
+
+// Supervises the driver with the watchdog. If the main loop stops feeding
+// the watchdog or the driver gives up, the reason, the state and the module
+// which was active are kept in memory which survives the reset.
+
+class Supervisor {
+    class Implementation;
+
+public:
+    enum class Reason : uint8_t {
+        None,
+        // the watchdog was not fed in time
+        Hang,
+        // the driver gave up
+        Crash
+    };
+
+    Supervisor(uint8_t timeout);
+    ~Supervisor();
+
+    // Arms the watchdog. Returns true if the driver comes back from a failure.
+    bool begin(void);
+
+    void feed(void);
+
+    void enter(uint8_t module);
+    void track(uint8_t state);
+
+    // Records the reason and lets the watchdog reset the driver.
+    void fail(Reason reason);
+
+    // The watchdog keeps running in power down, so it has to be suspended.
+    void suspend(void);
+    void resume(void);
+
+    // Marks the driver as back in operation, true the first time after a failure.
+    bool recover(void);
+
+    bool hasRecovered(void);
+    Reason reason(void);
+    uint8_t state(void);
+    uint8_t module(void);
+    uint16_t recoveries(void);
+    // ms from the failure until recover() was called
+    uint32_t recoveryTime(void);
+
+private:
+    Supervisor(const Supervisor&);
+    Supervisor& operator=(const Supervisor&);
+
+    Implementation *impl;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "Timer.h"
+
+#define SLOTS_MASK (Timer::Slots - 1)
+#define SLOTS_SHIFT 3
+
+static_assert((1 << SLOTS_SHIFT) == Timer::Slots, "slots must be a power of two");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+Timer *slots[Timer::Slots];
+
+// time of the wheel, trails millis() until the next tick
+uint16_t now;
+bool turning = false;
+
+// the wheel starts at the time of the first tick or timer
+void align() {
+    if (!turning) {
+        now = millis();
+        turning = true;
+    }
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Timer::Timer(callback_t callback)
+    : callback(callback) {
+    next = nullptr;
+    period = 0;
+    rounds = 0;
+    started = 0;
+    slot = 0;
+    flags = 0;
+}
+
+Timer::~Timer() {
+    stop();
+}
+
+void Timer::start(uint16_t ms) {
+    align();
+    stop();
+    flags = Running;
+    period = ms;
+    started = now;
+    schedule(ms);
+}
+
+void Timer::repeat(uint16_t ms) {
+    align();
+    stop();
+    flags = Running | Periodic;
+    period = ms;
+    started = now;
+    schedule(ms);
+}
+
+void Timer::stop() {
+    if (flags & (Running | Watching)) {
+        unlink();
+    }
+    flags = 0;
+}
+
+bool Timer::isRunning() {
+    return flags & Running;
+}
+
+bool Timer::hasExpired() {
+    return flags & Expired;
+}
+
+bool Timer::hasFired() {
+    bool fired = flags & Fired;
+    flags &= ~Fired;
+    return fired;
+}
+
+uint16_t Timer::elapsed() {
+    if (flags & Saturated) {
+        return 0xFFFF;
+    }
+    return now - started;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Timer::tick() {
+    align();
+    uint16_t ms = millis();
+    while (now != ms) {
+        now++;
+        // due timers are taken off, the others are linked again
+        uint8_t index = now & SLOTS_MASK;
+        Timer *timer = slots[index];
+        slots[index] = nullptr;
+        while (timer) {
+            Timer *following = timer->next;
+            if (timer->rounds > 0) {
+                timer->rounds--;
+                timer->link();
+            }
+            else {
+                timer->fire();
+            }
+            timer = following;
+        }
+    }
+}
+
+// A delay of ms reaches its slot after ((ms - 1) & mask) + 1 ticks and then
+// needs (ms - 1) >> shift more turns of the wheel.
+void Timer::schedule(uint16_t ms) {
+    if (ms == 0) {
+        ms = 1;
+    }
+    slot = (now + ms) & SLOTS_MASK;
+    rounds = (ms - 1) >> SLOTS_SHIFT;
+    link();
+}
+
+void Timer::link() {
+    next = slots[slot];
+    slots[slot] = this;
+}
+
+void Timer::unlink() {
+    Timer **link = &slots[slot];
+    while (*link && *link != this) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = next;
+    }
+    next = nullptr;
+}
+
+// the timer is already off its slot
+void Timer::fire() {
+    if (flags & Watching) {
+        flags = (flags & Fired) | Expired | Saturated;
+        return;
+    }
+    flags |= Fired;
+    if (flags & Periodic) {
+        schedule(period);
+    }
+    else if (period < 0xFFFF) {
+        // back on the wheel until 65535 ms after the start
+        flags = (flags & ~Running) | Expired | Watching;
+        schedule(0xFFFF - period);
+    }
+    else {
+        flags = (flags & ~Running) | Expired | Saturated;
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
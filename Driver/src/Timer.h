@@ -0,0 +1,71 @@
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+#include <Arduino.h>
+
+// One-shot and periodic software timers with millisecond resolution. Running
+// timers hang in the slots of a single timer wheel, which is advanced by
+// tick() from the main loop, so modules don't poll their own clocks. Times
+// are 16-bit and relative, which limits delays to a minute, and they survive
+// the rollover of millis(). A one-shot timer stays on the wheel after it
+// expired until elapsed() reaches its limit, so it can saturate there.
+
+class Timer {
+public:
+    // Runs within tick(), may start or stop its own timer only.
+    typedef void (*callback_t)(void);
+
+    enum { Slots = 8 };
+
+    Timer(callback_t callback = nullptr);
+    ~Timer();
+
+    // Fires once after ms milliseconds.
+    void start(uint16_t ms);
+    // Fires every ms milliseconds.
+    void repeat(uint16_t ms);
+    void stop(void);
+
+    bool isRunning(void);
+    // true if a one-shot timer fired and was not started again
+    bool hasExpired(void);
+    // true once after each firing
+    bool hasFired(void);
+    // milliseconds since the timer was last started, one-shot timers stay at
+    // 65535 from there, periodic ones wrap
+    uint16_t elapsed(void);
+
+    // Advances the wheel to millis() and fires the due timers (runs their
+    // callbacks). Has to be called at least once a minute.
+    static void tick(void);
+
+private:
+    Timer(const Timer&);
+    Timer& operator=(const Timer&);
+
+    enum Flags : uint8_t {
+        Running = 1,
+        Periodic = 2,
+        Fired = 4,
+        Expired = 8,
+        // expired, on the wheel until elapsed() saturates
+        Watching = 16,
+        Saturated = 32
+    };
+
+    void schedule(uint16_t ms);
+    void link(void);
+    void unlink(void);
+    void fire(void);
+
+    callback_t callback;
+    Timer *next;
+    uint16_t period;
+    // full turns of the wheel left before firing
+    uint16_t rounds;
+    uint16_t started;
+    uint8_t slot;
+    uint8_t flags;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "Tracer.h"
+
+// latencies are kept in units of 4 microseconds, the resolution of micros()
+#define RESOLUTION_SHIFT 2
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct record_t {
+    uint16_t latencies[Tracer::Stages];
+};
+
+record_t records[Tracer::Records];
+uint8_t records_next = 0;
+uint8_t records_count = 0;
+
+bool tracing = false;
+uint8_t marked;
+uint32_t opened;
+record_t current;
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Tracer::begin(uint32_t since) {
+    tracing = true;
+    marked = 0;
+    opened = since;
+    mark(Sensed);
+}
+
+void Tracer::mark(Stage stage) {
+    if (!tracing || (marked & _BV(stage))) {
+        return;
+    }
+    uint32_t latency = (micros() - opened) >> RESOLUTION_SHIFT;
+    current.latencies[stage] = latency > 0xFFFF ? 0xFFFF : latency;
+    marked |= _BV(stage);
+
+    if (marked == _BV(Stages) - 1) {
+        records[records_next] = current;
+        records_next = (records_next + 1) % Records;
+        if (records_count < Records) {
+            records_count++;
+        }
+        tracing = false;
+    }
+}
+
+void Tracer::abandon() {
+    tracing = false;
+}
+
+uint8_t Tracer::count() {
+    return records_count;
+}
+
+Tracer::percentiles_t Tracer::percentiles(Stage stage) {
+    percentiles_t percentiles = { 0, 0, 0 };
+    if (records_count == 0) {
+        return percentiles;
+    }
+
+    uint16_t sorted[Records];
+    for (uint8_t index = 0; index < records_count; index++) {
+        uint16_t latency = records[index].latencies[stage];
+        uint8_t position = index;
+        while (position > 0 && sorted[position - 1] > latency) {
+            sorted[position] = sorted[position - 1];
+            position--;
+        }
+        sorted[position] = latency;
+    }
+
+    percentiles.median = uint32_t(sorted[(records_count - 1) / 2]) << RESOLUTION_SHIFT;
+    percentiles.p90 = uint32_t(sorted[(records_count - 1) * 9 / 10]) << RESOLUTION_SHIFT;
+    percentiles.maximum = uint32_t(sorted[records_count - 1]) << RESOLUTION_SHIFT;
+    return percentiles;
+}
+
+void Tracer::clear() {
+    records_next = 0;
+    records_count = 0;
+    tracing = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,57 @@
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#include <Arduino.h>
+
+#include "Jack.h"
+
+// Traces the stages of triggers from the sensor edge to the first frame of
+// lights. Trace points are spread over several modules, so the tracer is a
+// single static instance.
+
+class Tracer {
+public:
+    enum Stage : uint8_t {
+        // motion seen by the receptor
+        Sensed,
+        // state machine went to triggered
+        Triggered,
+        // activator released
+        Released,
+        // laugh sent to the mp3 module
+        Laughed,
+        // first frame of the dance shown
+        Shown,
+
+        Stages
+    };
+
+    enum { Records = 16 };
+
+    struct percentiles_t {
+        uint32_t median;
+        uint32_t p90;
+        uint32_t maximum;
+    };
+
+    // Opens a trace, times are relative to since (micros) which is the
+    // earliest the edge could have happened.
+    static void begin(uint32_t since);
+    static void mark(Stage stage);
+    static void abandon(void);
+
+    // number of complete traces in the ring
+    static uint8_t count(void);
+    // latencies of a stage in microseconds across the ring
+    static percentiles_t percentiles(Stage stage);
+
+    static void clear(void);
+};
+
+#if TRACER
+#define TRACE(stage) Tracer::mark(Tracer::stage)
+#else
+#define TRACE(stage)
+#endif
+
+#endif
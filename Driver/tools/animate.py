@@ -0,0 +1,259 @@
+"""Converts image strips into the animations of the indicator.
+
+    python tools/animate.py [--output src/Animations] [--keyframes 0] animations/*.png
+
+Each image is one animation: a row per frame (played at 25 frames per
+second), a column per LED, as 8 bit RGB or RGBA PNG or as binary PPM. The
+name of the file names the animation. Writes Animations.h with the numbers
+of the animations and Animations.cpp with the data in PROGMEM, and prints
+the size of each animation against its raw frames.
+
+A frame is a list of operations on the previous frame, which together cover
+every LED. Operations start with a byte of the kind (upper two bits) and
+the count of LEDs less one (lower six bits):
+
+    00 skip   LEDs stay as they are
+    01 fill   LEDs take the color that follows (3 bytes)
+    10 copy   LEDs take the colors that follow (3 bytes each)
+    11 delta  LEDs change by the deltas that follow, 5 bit signed per
+              channel packed as 0rrrrrgggggbbbbb (2 bytes each, little endian)
+
+The first frame, and with --keyframes every n-th frame, is a keyframe,
+which neither skips nor changes LEDs, so playback can start there.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+SKIP, FILL, COPY, DELTA = 0, 1, 2, 3
+LONGEST = 64
+DELTA_MIN, DELTA_MAX = -16, 15
+
+
+def read_png(path):
+    with open(path, 'rb') as file:
+        data = file.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('%s is not a PNG' % path)
+    offset = 8
+    header = None
+    compressed = b''
+    while offset < len(data):
+        length, kind = struct.unpack_from('>I4s', data, offset)
+        chunk = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+        if kind == b'IHDR':
+            header = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'IDAT':
+            compressed += chunk
+        elif kind == b'IEND':
+            break
+    width, height, depth, color, _, _, interlace = header
+    if depth != 8 or color not in (2, 6) or interlace:
+        raise ValueError('%s: only 8 bit RGB or RGBA PNGs without interlacing' % path)
+    channels = 3 if color == 2 else 4
+    raw = zlib.decompress(compressed)
+    stride = width * channels
+    rows = []
+    previous = bytearray(stride)
+    position = 0
+    for _ in range(height):
+        kind = raw[position]
+        line = bytearray(raw[position + 1:position + 1 + stride])
+        position += 1 + stride
+        for index in range(stride):
+            left = line[index - channels] if index >= channels else 0
+            up = previous[index]
+            corner = previous[index - channels] if index >= channels else 0
+            if kind == 1:
+                line[index] = (line[index] + left) & 0xFF
+            elif kind == 2:
+                line[index] = (line[index] + up) & 0xFF
+            elif kind == 3:
+                line[index] = (line[index] + (left + up) // 2) & 0xFF
+            elif kind == 4:
+                estimate = left + up - corner
+                distances = (abs(estimate - left), abs(estimate - up), abs(estimate - corner))
+                predictor = (left, up, corner)[distances.index(min(distances))]
+                line[index] = (line[index] + predictor) & 0xFF
+        rows.append([tuple(line[x * channels:x * channels + 3]) for x in range(width)])
+        previous = line
+    return rows
+
+
+def read_ppm(path):
+    with open(path, 'rb') as file:
+        data = file.read()
+    fields = re.match(rb'P6\s+(?:#.*\s+)*(\d+)\s+(\d+)\s+(\d+)\s', data)
+    if not fields or int(fields.group(3)) != 255:
+        raise ValueError('%s: only binary PPMs with 8 bit channels' % path)
+    width, height = int(fields.group(1)), int(fields.group(2))
+    pixels = data[fields.end():]
+    return [[tuple(pixels[(y * width + x) * 3:(y * width + x) * 3 + 3]) for x in range(width)]
+            for y in range(height)]
+
+
+def read(path):
+    with open(path, 'rb') as file:
+        magic = file.read(2)
+    return read_ppm(path) if magic == b'P6' else read_png(path)
+
+
+def deltas(old, new):
+    change = tuple(n - o for o, n in zip(old, new))
+    return change if all(DELTA_MIN <= c <= DELTA_MAX for c in change) else None
+
+
+def encode_frame(frame, previous):
+    """Returns the operations turning previous (None for a keyframe) into frame."""
+    output = bytearray()
+    count = len(frame)
+    index = 0
+
+    def same(at):
+        return previous is not None and frame[at] == previous[at]
+
+    def filled(at):
+        return at + 1 < count and frame[at] == frame[at + 1]
+
+    def changed(at):
+        return previous is not None and deltas(previous[at], frame[at]) is not None
+
+    while index < count:
+        start = index
+        if same(index):
+            while index < count and index - start < LONGEST and same(index):
+                index += 1
+            output.append(SKIP << 6 | (index - start - 1))
+        elif filled(index):
+            color = frame[index]
+            while index < count and index - start < LONGEST and frame[index] == color:
+                index += 1
+            output.append(FILL << 6 | (index - start - 1))
+            output.extend(color)
+        elif changed(index):
+            while index < count and index - start < LONGEST and changed(index) \
+                    and not same(index) and not filled(index):
+                index += 1
+            output.append(DELTA << 6 | (index - start - 1))
+            for at in range(start, index):
+                r, g, b = deltas(previous[at], frame[at])
+                output.extend(struct.pack('<H', (r & 0x1F) << 10 | (g & 0x1F) << 5 | (b & 0x1F)))
+        else:
+            while index < count and index - start < LONGEST and not same(index) \
+                    and not (index > start and filled(index)) and not changed(index):
+                index += 1
+            output.append(COPY << 6 | (index - start - 1))
+            for at in range(start, index):
+                output.extend(frame[at])
+    return output
+
+
+def encode(frames, keyframes):
+    output = bytearray()
+    previous = None
+    for number, frame in enumerate(frames):
+        keyframe = number == 0 or (keyframes and number % keyframes == 0)
+        output.extend(encode_frame(frame, None if keyframe else previous))
+        previous = frame
+    return output
+
+
+def decode(data, leds, frames):
+    """Plays the operations back, as the indicator does."""
+    output = []
+    current = [(0, 0, 0)] * leds
+    position = 0
+    for _ in range(frames):
+        current = list(current)
+        index = 0
+        while index < leds:
+            operation = data[position]
+            position += 1
+            kind, count = operation >> 6, (operation & 0x3F) + 1
+            if kind == FILL:
+                color = tuple(data[position:position + 3])
+                position += 3
+            for at in range(index, index + count):
+                if kind == FILL:
+                    current[at] = color
+                elif kind == COPY:
+                    current[at] = tuple(data[position:position + 3])
+                    position += 3
+                elif kind == DELTA:
+                    packed, = struct.unpack_from('<H', data, position)
+                    position += 2
+                    change = [(packed >> shift) & 0x1F for shift in (10, 5, 0)]
+                    change = [c - 32 if c & 0x10 else c for c in change]
+                    current[at] = tuple(max(0, min(255, c + d)) for c, d in zip(current[at], change))
+            index += count
+        output.append(current)
+    return output
+
+
+def identifier(path):
+    name = os.path.splitext(os.path.basename(path))[0]
+    return re.sub(r'\W', '_', name)
+
+
+def generate(paths, output, keyframes):
+    animations = []
+    for path in paths:
+        frames = read(path)
+        leds = len(frames[0])
+        if leds > 255 or len(frames) > 0xFFFF:
+            raise ValueError('%s: at most 255 LEDs and 65535 frames' % path)
+        data = encode(frames, keyframes)
+        if decode(data, leds, len(frames)) != [list(frame) for frame in frames]:
+            raise ValueError('%s: encoding does not play back' % path)
+        raw = leds * len(frames) * 3
+        animations.append((identifier(path), leds, len(frames), data, raw))
+        print('%s: %d frames of %d LEDs, %d bytes of %d (%.1f:1)' % (
+            identifier(path), len(frames), leds, len(data), raw, float(raw) / len(data)))
+
+    guard = '__ANIMATIONS_H__'
+    with open(output + '.h', 'w') as file:
+        file.write('#ifndef %s\n#define %s\n\n' % (guard, guard))
+        file.write('// Generated by tools/animate.py, do not edit.\n\n')
+        file.write('#include "Indicator.h"\n\n')
+        file.write('enum animation_number_t : uint8_t {\n')
+        for name, _, _, _, _ in animations:
+            file.write('    %s_animation,\n' % name)
+        file.write('    animations_count\n};\n\n')
+        file.write('extern const Indicator::animation_t animations[animations_count] PROGMEM;\n\n')
+        file.write('#endif\n')
+
+    with open(output + '.cpp', 'w') as file:
+        file.write('#include "Animations.h"\n\n')
+        file.write('// Generated by tools/animate.py, do not edit.\n')
+        for name, leds, frames, data, raw in animations:
+            file.write('\n// %s: %d frames of %d LEDs, %d bytes of %d (%.1f:1)\n' % (
+                name, frames, leds, len(data), raw, float(raw) / len(data)))
+            file.write('const uint8_t %s_data[] PROGMEM = {\n' % name)
+            for start in range(0, len(data), 16):
+                file.write('    %s,\n' % ', '.join('0x%02X' % byte for byte in data[start:start + 16]))
+            file.write('};\n')
+        file.write('\nconst Indicator::animation_t animations[animations_count] PROGMEM = {\n')
+        for name, leds, frames, _, _ in animations:
+            file.write('    { %s_data, %d, %d },\n' % (name, frames, leds))
+        file.write('};\n')
+
+
+def main(arguments):
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='Converts image strips into animations.')
+    parser.add_argument('images', nargs='+', help='PNG or PPM, a row per frame, a column per LED')
+    parser.add_argument('--output', default=os.path.join(here, '..', 'src', 'Animations'),
+                        help='path of the generated files without extension')
+    parser.add_argument('--keyframes', type=int, default=0, help='keyframe every n frames')
+    options = parser.parse_args(arguments)
+    generate(options.images, options.output, options.keyframes)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
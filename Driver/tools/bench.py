@@ -0,0 +1,142 @@
+"""Runs the micro benchmarks of bench/Bench.cpp under simavr and compares
+cycles per call, flash and RAM against a stored baseline.
+
+    python tools/bench.py [--no-build] [--save] [--threshold 5] [--simavr simavr]
+
+Builds the bench and the firmware environments with PlatformIO, runs the
+bench firmware on a simulated ATmega328P at 16 MHz and reads the sizes of the
+firmware. Results worse than the baseline by more than the threshold (in
+percent) are flagged as regressions and make the script fail. --save stores
+the results as the new baseline (bench/baseline.json).
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PROJECT = os.path.join(HERE, '..')
+BASELINE = os.path.join(PROJECT, 'bench', 'baseline.json')
+
+BENCH = 'bench'
+FIRMWARE = 'pro16MHzatmega328'
+
+LINE = re.compile(r'bench (\S+) (\d+) (\d+) (\d+)')
+
+# sections of avr-size -A counted as flash and as RAM
+FLASH = ('.text', '.data')
+RAM = ('.data', '.bss', '.noinit')
+
+
+def build(environment):
+    subprocess.check_call(['pio', 'run', '-e', environment], cwd=PROJECT)
+
+
+def elf(environment):
+    return os.path.join(PROJECT, '.pio', 'build', environment, 'firmware.elf')
+
+
+def tool(name):
+    """Finds a tool of the avr toolchain, on the path or in PlatformIO's packages."""
+    found = shutil.which(name)
+    if found:
+        return found
+    packages = os.path.expanduser(os.path.join('~', '.platformio', 'packages'))
+    candidates = glob.glob(os.path.join(packages, 'toolchain-atmelavr*', 'bin', name))
+    if not candidates:
+        sys.exit('%s not found' % name)
+    return candidates[0]
+
+
+def run(simavr, timeout):
+    """Returns {name: {'calls', 'mean', 'max'}} from the output of the bench firmware."""
+    try:
+        result = subprocess.run([simavr, '-m', 'atmega328p', '-f', '16000000', elf(BENCH)],
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=timeout)
+        output = result.stdout
+    except subprocess.TimeoutExpired as expired:
+        output = expired.stdout or b''
+    output = output.decode('latin-1')
+    if 'bench done' not in output:
+        sys.exit('benchmarks did not finish:\n' + output[-2000:])
+    return {
+        name: {'calls': int(calls), 'mean': int(mean), 'max': int(maximum)}
+        for name, calls, mean, maximum in LINE.findall(output)
+    }
+
+
+def sizes(path):
+    """Returns flash and RAM used by an elf file in bytes."""
+    output = subprocess.check_output([tool('avr-size'), '-A', path]).decode()
+    sections = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[1].isdigit():
+            sections[fields[0]] = int(fields[1])
+    return {
+        'flash': sum(sections.get(name, 0) for name in FLASH),
+        'ram': sum(sections.get(name, 0) for name in RAM),
+    }
+
+
+def compare(label, value, base, threshold):
+    """Prints a row, returns True for a regression."""
+    if base is None:
+        print('%-20s %10d %10s' % (label, value, 'new'))
+        return False
+    delta = value - base
+    percent = 100.0 * delta / base if base else 0.0
+    regression = percent > threshold
+    print('%-20s %10d %+10d %+7.1f%%%s' % (label, value, delta, percent, '  REGRESSION' if regression else ''))
+    return regression
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Runs the micro benchmarks under simavr.')
+    parser.add_argument('--no-build', action='store_true', help='use the existing builds')
+    parser.add_argument('--save', action='store_true', help='store the results as baseline')
+    parser.add_argument('--threshold', type=float, default=5.0, help='tolerated slowdown in percent')
+    parser.add_argument('--simavr', default='simavr')
+    parser.add_argument('--timeout', type=int, default=600, help='seconds')
+    parser.add_argument('--baseline', default=BASELINE)
+    options = parser.parse_args()
+
+    if not options.no_build:
+        build(BENCH)
+        build(FIRMWARE)
+
+    results = {
+        'benchmarks': run(options.simavr, options.timeout),
+        'sizes': sizes(elf(FIRMWARE)),
+    }
+
+    baseline = {'benchmarks': {}, 'sizes': {}}
+    if os.path.exists(options.baseline):
+        with open(options.baseline) as file:
+            baseline = json.load(file)
+
+    print('%-20s %10s %10s %8s' % ('cycles (mean)', 'now', 'delta', ''))
+    regressions = 0
+    for name, result in sorted(results['benchmarks'].items()):
+        base = baseline['benchmarks'].get(name)
+        regressions += compare(name, result['mean'], base['mean'] if base else None, options.threshold)
+    print('%-20s %10s %10s %8s' % ('bytes', 'now', 'delta', ''))
+    for name, value in sorted(results['sizes'].items()):
+        regressions += compare(name, value, baseline['sizes'].get(name), options.threshold)
+
+    if options.save:
+        with open(options.baseline, 'w') as file:
+            json.dump(results, file, indent=2, sort_keys=True)
+            file.write('\n')
+        print('baseline saved to %s' % options.baseline)
+        return 0
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
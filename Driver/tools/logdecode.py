@@ -0,0 +1,174 @@
+"""Decodes the binary log of the driver into text.
+
+    python tools/logdecode.py [--table messages.json] [--baud 9600] [--send LINE] [--edges FILE] [input]
+
+input is a serial device, a file with a captured log or - for stdin (the
+default). The message table is generated at build time into the build
+directory (.pio/build/<env>/messages.json); without one it is parsed from
+src/Messages.h.
+
+Command lines given with --send are written to a serial device once it is
+open, e.g. 'list' to show the configuration. Reading a serial device, lines
+typed on stdin are sent as commands as well.
+
+Captured input edges (command 'c') are written to the file given with
+--edges as lines '<pin> <level> <delta ms>', which the native build replays
+with --replay.
+"""
+
+import argparse
+import glob
+import json
+import os
+import select
+import struct
+import sys
+
+import messages
+
+SYNC = 0xA5
+HEADER = 5
+
+WIDTHS = {'b': ('<B', 1), 'u': ('<H', 2), 'U': ('<I', 4), 's': ('<B', 1)}
+
+
+def load(path):
+    if path:
+        with open(path) as file:
+            return json.load(file)
+    here = os.path.dirname(os.path.abspath(__file__))
+    tables = sorted(glob.glob(os.path.join(here, '..', '.pio*', 'build', '*', 'messages.json')) +
+                    glob.glob(os.path.join(here, '..', '.pioenvs', '*', 'messages.json')),
+                    key=os.path.getmtime)
+    if tables:
+        with open(tables[-1]) as file:
+            return json.load(file)
+    return messages.parse(os.path.join(here, '..', 'src', 'Messages.h'))
+
+
+def render(text, arguments, names):
+    """Formats a message, returns None if the arguments do not fit."""
+    output = []
+    offset = 0
+    index = 0
+    while index < len(text):
+        character = text[index]
+        if character != '%' or index + 1 >= len(text) or text[index + 1] not in WIDTHS:
+            output.append(character)
+            index += 1
+            continue
+        kind = text[index + 1]
+        index += 2
+        layout, width = WIDTHS[kind]
+        if offset + width > len(arguments):
+            return None
+        value, = struct.unpack_from(layout, arguments, offset)
+        offset += width
+        if kind == 's' and index < len(text) and text[index] == '(':
+            end = text.index(')', index)
+            values = names.get(text[index + 1:end], [])
+            index = end + 1
+            output.append(values[value] if value < len(values) else '#%d' % value)
+        else:
+            output.append(str(value))
+    if offset != len(arguments):
+        return None
+    return ''.join(output)
+
+
+class Decoder(object):
+
+    def __init__(self, table):
+        self.formats = {message['id']: message['format'] for message in table['messages']}
+        self.ids = {message['name']: message['id'] for message in table['messages']}
+        self.edges = None
+        self.names = table['names']
+        self.buffer = bytearray()
+        self.last = None
+        self.epoch = 0
+
+    def timestamp(self, ms):
+        # timestamps are 16 bit, logs are assumed to be at most a minute apart
+        if self.last is not None and ms < self.last:
+            self.epoch += 0x10000
+        self.last = ms
+        return (self.epoch + ms) / 1000.0
+
+    def feed(self, data):
+        self.buffer.extend(data)
+        while True:
+            start = self.buffer.find(bytes([SYNC]))
+            if start < 0:
+                del self.buffer[:]
+                return
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER:
+                return
+            number, length, ms = struct.unpack_from('<BBH', self.buffer, 1)
+            if len(self.buffer) < HEADER + length:
+                return
+            arguments = bytes(self.buffer[HEADER:HEADER + length])
+            text = self.formats.get(number)
+            line = render(text, arguments, self.names) if text is not None else None
+            if line is None:
+                # not a record after all, resynchronize on the next byte
+                del self.buffer[:1]
+                continue
+            del self.buffer[:HEADER + length]
+            if self.edges and number == self.ids.get('Edge'):
+                self.edges.write('%d %d %d\n' % struct.unpack('<BBH', arguments))
+                self.edges.flush()
+            yield '[%10.3f] %s' % (self.timestamp(ms), line)
+
+
+def open_input(path, baud):
+    if path == '-':
+        return sys.stdin.buffer.fileno(), False
+    descriptor = os.open(path, os.O_RDWR | os.O_NOCTTY if os.path.exists(path) else os.O_RDONLY)
+    if os.isatty(descriptor):
+        import termios
+        import tty
+        tty.setraw(descriptor)
+        attributes = termios.tcgetattr(descriptor)
+        speed = getattr(termios, 'B%d' % baud)
+        attributes[4] = attributes[5] = speed
+        termios.tcsetattr(descriptor, termios.TCSANOW, attributes)
+        return descriptor, True
+    return descriptor, False
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decodes the binary log of the driver.')
+    parser.add_argument('input', nargs='?', default='-')
+    parser.add_argument('--table', help='message table generated at build time')
+    parser.add_argument('--baud', type=int, default=9600)
+    parser.add_argument('--send', action='append', default=[], help='command line to send to a serial device')
+    parser.add_argument('--edges', help='file to write captured input edges to')
+    options = parser.parse_args()
+
+    decoder = Decoder(load(options.table))
+    if options.edges:
+        decoder.edges = open(options.edges, 'w')
+    descriptor, device = open_input(options.input, options.baud)
+    if device:
+        for command in options.send:
+            os.write(descriptor, (command + '\n').encode())
+
+    sources = [descriptor]
+    if device and sys.stdin.isatty():
+        sources.append(sys.stdin.fileno())
+    while True:
+        readable, _, _ = select.select(sources, [], [])
+        if descriptor not in readable:
+            os.write(descriptor, sys.stdin.readline().encode())
+            continue
+        data = os.read(descriptor, 256)
+        if not data:
+            break
+        for line in decoder.feed(data):
+            print(line)
+            sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
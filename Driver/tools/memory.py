@@ -0,0 +1,125 @@
+"""Breaks down flash and static RAM per module from the linker map.
+
+Runs as a PlatformIO extra script (links with a map and adds the target
+'memory': pio run -e pro16MHzatmega328 -t memory) or standalone:
+
+    python tools/memory.py [--flash 30720] [--ram 2048] [--stack 512] firmware.map
+
+Modules are the translation units of src/, the libraries and the core. The
+heap (the implementations behind the modules) and the stack come on top of
+the static RAM at runtime, so the script fails if less than --stack bytes are
+left for both. The monitor reports the actual free memory on the device.
+"""
+
+import argparse
+import collections
+import os
+import re
+import sys
+
+# output sections and the memories they take
+FLASH = ('.text', '.data')
+RAM = ('.data', '.bss', '.noinit')
+
+INPUT = re.compile(r'^ (\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$')
+CONTINUED = re.compile(r'^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$')
+OUTPUT = re.compile(r'^(\.\w+)\s')
+
+
+def module(path):
+    """Names the module of an object file or archive member."""
+    path = path.strip()
+    member = re.match(r'(.*)\((.*)\)$', path)
+    if member:
+        archive = os.path.basename(member.group(1))
+        name = re.sub(r'^lib|\.a$', '', archive)
+        return 'core' if name == 'FrameworkArduino' else name
+    parts = path.replace('\\', '/').split('/')
+    name = re.sub(r'\.(c|cpp|S)\.o$|\.o$', '', parts[-1])
+    # objects of libraries are built into lib<hash>/<library>/
+    for index, part in enumerate(parts[:-1]):
+        if re.match(r'lib[0-9a-f]+$', part) and index + 1 < len(parts) - 1:
+            return parts[index + 1]
+    return name
+
+
+def parse(path):
+    """Returns {module: {'flash': bytes, 'ram': bytes}}."""
+    usage = collections.defaultdict(lambda: {'flash': 0, 'ram': 0})
+    with open(path) as file:
+        lines = file.read().splitlines()
+    try:
+        start = lines.index('Linker script and memory map')
+    except ValueError:
+        raise ValueError('%s is not a linker map' % path)
+
+    output = None
+    pending = None
+    for line in lines[start + 1:]:
+        heading = OUTPUT.match(line)
+        if heading:
+            output = heading.group(1)
+            pending = None
+            continue
+        match = INPUT.match(line)
+        if match:
+            size, name = int(match.group(3), 16), match.group(4)
+        else:
+            continued = CONTINUED.match(line) if pending else None
+            pending = None
+            if not continued:
+                # long section names continue on the next line
+                if re.match(r'^ [.\w]\S*$', line):
+                    pending = line.strip()
+                continue
+            size, name = int(continued.group(2), 16), continued.group(3)
+        if size == 0 or output is None or not (name.endswith('.o') or name.endswith(')')):
+            continue
+        if output in FLASH:
+            usage[module(name)]['flash'] += size
+        if output in RAM:
+            usage[module(name)]['ram'] += size
+    return usage
+
+
+def report(usage, flash, ram, stack):
+    print('%-24s %8s %8s' % ('module', 'flash', 'ram'))
+    for name, used in sorted(usage.items(), key=lambda item: (-item[1]['flash'], item[0])):
+        print('%-24s %8d %8d' % (name, used['flash'], used['ram']))
+    total_flash = sum(used['flash'] for used in usage.values())
+    total_ram = sum(used['ram'] for used in usage.values())
+    print('%-24s %8d %8d' % ('total', total_flash, total_ram))
+    print('%-24s %8d %8d' % ('left', flash - total_flash, ram - total_ram))
+
+    failed = False
+    if total_flash > flash:
+        print('flash exceeds %d bytes' % flash)
+        failed = True
+    if ram - total_ram < stack:
+        print('less than %d bytes left for heap and stack' % stack)
+        failed = True
+    return failed
+
+
+def main(arguments):
+    parser = argparse.ArgumentParser(description='Breaks down flash and static RAM per module.')
+    parser.add_argument('map', help='linker map')
+    parser.add_argument('--flash', type=int, default=30720, help='flash without the bootloader')
+    parser.add_argument('--ram', type=int, default=2048)
+    parser.add_argument('--stack', type=int, default=512, help='bytes needed for heap and stack')
+    options = parser.parse_args(arguments)
+    return 1 if report(parse(options.map), options.flash, options.ram, options.stack) else 0
+
+
+try:
+    Import('env')  # noqa: F821 - provided by PlatformIO
+except NameError:
+    if __name__ == '__main__':
+        sys.exit(main(sys.argv[1:]))
+else:
+    env.Append(LINKFLAGS=['-Wl,-Map,$BUILD_DIR/firmware.map'])  # noqa: F821
+    env.AddCustomTarget(  # noqa: F821
+        'memory', '$BUILD_DIR/${PROGNAME}.elf',
+        '"$PYTHONEXE" "%s" "$BUILD_DIR/firmware.map"' % os.path.join(
+            env.subst('$PROJECT_DIR'), 'tools', 'memory.py'),  # noqa: F821
+        title='Memory', description='Flash and static RAM per module')
@@ -0,0 +1,67 @@
+"""Generates the message table of the logger from src/Messages.h.
+
+Runs as a PlatformIO extra script (writes messages.json into the build
+directory) or standalone:
+
+    python tools/messages.py [src/Messages.h] [messages.json]
+"""
+
+import json
+import os
+import re
+import sys
+
+MESSAGE = re.compile(r'M\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+NAMES = re.compile(r'N\(\s*(\w+)\s*,((?:\s*"(?:[^"\\]|\\.)*"\s*,?)+)\)')
+STRING = re.compile(r'"((?:[^"\\]|\\.)*)"')
+
+
+def block(source, name):
+    """Returns the body of the macro #define name(...)."""
+    match = re.search(r'#define\s+%s\(\w\)((?:.*\\\n)*.*)' % name, source)
+    if not match:
+        raise ValueError('no %s in message header' % name)
+    return match.group(1).replace('\\\n', ' ')
+
+
+def parse(path):
+    with open(path) as header:
+        source = header.read()
+    messages = [
+        {'id': number, 'name': name, 'format': text}
+        for number, (name, text) in enumerate(MESSAGE.findall(block(source, 'MESSAGES')))
+    ]
+    names = {
+        name: STRING.findall(values)
+        for name, values in NAMES.findall(block(source, 'NAMES'))
+    }
+    return {'messages': messages, 'names': names}
+
+
+def generate(header, output):
+    table = parse(header)
+    directory = os.path.dirname(output)
+    if directory and not os.path.isdir(directory):
+        os.makedirs(directory)
+    with open(output, 'w') as file:
+        json.dump(table, file, indent=1)
+    return table
+
+
+def main(arguments):
+    here = os.path.dirname(os.path.abspath(__file__))
+    header = arguments[0] if len(arguments) > 0 else os.path.join(here, '..', 'src', 'Messages.h')
+    output = arguments[1] if len(arguments) > 1 else 'messages.json'
+    table = generate(header, output)
+    print('%s: %d messages' % (output, len(table['messages'])))
+
+
+try:
+    Import('env')  # noqa: F821 - provided by PlatformIO
+except NameError:
+    if __name__ == '__main__':
+        main(sys.argv[1:])
+else:
+    generate(
+        os.path.join(env.subst('$PROJECT_SRC_DIR'), 'Messages.h'),  # noqa: F821
+        os.path.join(env.subst('$BUILD_DIR'), 'messages.json'))  # noqa: F821
@@ -0,0 +1,121 @@
+"""Streams LED frames to the driver over its debug serial.
+
+    python tools/stream.py [--fps 20] [--leds 12] [--indexed] [--loop] [--baud 9600]
+                           [--trace] [--start 1000] [--image strip.png] output
+
+Frames come from an image strip (a row per frame, a column per LED, see
+tools/animate.py) or, without one, from a chase along the LEDs. With
+--indexed the first channel of each pixel is sent as an index into the
+Halloween palette of the driver, one byte per LED instead of three.
+
+output is a serial device, a pty (e.g. one end of socat) or - for stdout.
+Frames are written in realtime at --fps; at 9600 baud a frame of 12 RGB
+LEDs takes 44 ms on the wire, so about 20 frames per second are sustained.
+With --trace the frames are written as trace lines '<ms> data <hex>' for the
+native build instead, starting at --start ms.
+
+Frame: 0xFE, kind (0 RGB, 1 indexed), 8 bit sequence, number of LEDs, LEDs,
+CRC-16 (MODBUS) of kind to the last LED, little endian.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+import animate
+
+SYNC = 0xFE
+RGB, INDEXED = 0, 1
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16 as _crc16_update() of avr-libc."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def frame(pixels, sequence, indexed):
+    body = bytearray([INDEXED if indexed else RGB, sequence & 0xFF, len(pixels)])
+    for pixel in pixels:
+        body.extend(pixel[:1] if indexed else pixel)
+    return bytes([SYNC]) + bytes(body) + struct.pack('<H', crc16(body))
+
+
+def chase(leds):
+    """Yields frames of a dot running along the LEDs."""
+    position = 0
+    while True:
+        yield [(0xFF, 0x66, 0x00) if index == position else (0, 0, 0) for index in range(leds)]
+        position = (position + 1) % leds
+
+
+def frames(options):
+    if not options.image:
+        return chase(options.leds)
+    strip = animate.read(options.image)
+
+    def play():
+        while True:
+            for row in strip:
+                yield row
+            if not options.loop:
+                return
+    return play()
+
+
+def main(arguments):
+    parser = argparse.ArgumentParser(description='Streams LED frames to the driver.')
+    parser.add_argument('output', help='serial device, pty or - for stdout')
+    parser.add_argument('--image', help='image strip, a row per frame')
+    parser.add_argument('--leds', type=int, default=12, help='LEDs of the chase')
+    parser.add_argument('--fps', type=float, default=20.0)
+    parser.add_argument('--indexed', action='store_true', help='send palette indexes')
+    parser.add_argument('--loop', action='store_true', help='repeat the image strip')
+    parser.add_argument('--count', type=int, default=0, help='stop after so many frames')
+    parser.add_argument('--baud', type=int, default=9600)
+    parser.add_argument('--trace', action='store_true', help='write trace lines for the native build')
+    parser.add_argument('--start', type=float, default=1000.0, help='ms of the first trace line')
+    options = parser.parse_args(arguments)
+    if options.trace and not options.count and (not options.image or options.loop):
+        parser.error('--trace needs --count or an image strip played once')
+
+    if options.output == '-':
+        descriptor, device = sys.stdout.fileno(), False
+    else:
+        descriptor = os.open(options.output, os.O_RDWR | os.O_NOCTTY | os.O_CREAT, 0o644)
+        device = os.isatty(descriptor)
+        if not device and os.path.isfile(options.output):
+            os.ftruncate(descriptor, 0)
+    if device:
+        import termios
+        import tty
+        tty.setraw(descriptor)
+        attributes = termios.tcgetattr(descriptor)
+        attributes[4] = attributes[5] = getattr(termios, 'B%d' % options.baud)
+        termios.tcsetattr(descriptor, termios.TCSANOW, attributes)
+
+    period = 1.0 / options.fps
+    due = time.time()
+    for sequence, pixels in enumerate(frames(options)):
+        if options.count and sequence >= options.count:
+            break
+        data = frame(pixels, sequence, options.indexed)
+        if options.trace:
+            line = '%.3f data %s\n' % (options.start + sequence * period * 1000.0, data.hex())
+            os.write(descriptor, line.encode())
+            continue
+        os.write(descriptor, data)
+        due += period
+        delay = due - time.time()
+        if delay > 0:
+            time.sleep(delay)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))